@@ -0,0 +1,77 @@
+/*
+ * Benchmark: classic binary heap layout vs. the page-aware B-heap
+ * layout (PagedPriorityQueue) at sizes well beyond L3.
+ *
+ * Each heap is pre-filled with num_entries random priorities, then
+ * runs the "hold" model a scheduler sees in steady state: extract the
+ * minimum, re-insert it a random distance later. Reports throughput,
+ * sampled extract_min latency, and cache/dTLB misses (when perf
+ * events are available, otherwise "n/a").
+ *
+ * Usage: bheap_bench [num_entries ...]   (default 1M 16M 64M)
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+#include "../data_structures/PriorityQueue.h"
+#include "PerfCounter.h"
+
+static const long HOLD_OPS = 2000000;
+
+template <typename Queue>
+static void run(const char* name, long n) {
+    std::mt19937 rng(42);
+    Queue queue;
+    {
+        std::vector<std::pair<std::uint32_t, std::uint32_t>> items;
+        items.reserve(n);
+        for (long i = 0; i < n; i++) {
+            items.emplace_back(rng(), (std::uint32_t)i);
+        }
+        queue.bulk_load(std::move(items));
+    }
+
+    PerfCounter cache = PerfCounter::cache_misses();
+    PerfCounter tlb = PerfCounter::dtlb_misses();
+    std::vector<double> samples;
+    samples.reserve(HOLD_OPS / 64 + 1);
+
+    cache.start();
+    tlb.start();
+    auto start = std::chrono::steady_clock::now();
+    for (long op = 0; op < HOLD_OPS; op++) {
+        bool sample = (op & 63) == 0;
+        auto t0 = sample ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+        auto item = queue.extract_min();
+        if (sample) {
+            samples.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count());
+        }
+        queue.insert(item.second, item.first + (rng() >> 8));
+    }
+    double total_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::string tlb_misses = tlb.stop();
+    std::string cache_misses = cache.stop();
+
+    std::sort(samples.begin(), samples.end());
+    std::cout << "  " << name << ": " << (long long)(HOLD_OPS / total_s) << " ops/s, extract_min p50 "
+              << samples[samples.size() / 2] << " ns, p99 " << samples[samples.size() * 99 / 100]
+              << " ns, cache misses " << cache_misses << ", dTLB misses " << tlb_misses << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::vector<long> sizes;
+    for (int i = 1; i < argc; i++) sizes.push_back(std::atol(argv[i]));
+    if (sizes.empty()) sizes = {1000000L, 16000000L, 64000000L};
+
+    for (long n : sizes) {
+        std::cout << n << " entries (" << (n * 8 >> 20) << " MB), " << HOLD_OPS << " hold operations:" << std::endl;
+        run<PriorityQueue<std::uint32_t, std::uint32_t>>("binary", n);
+        run<PagedPriorityQueue<std::uint32_t, std::uint32_t>>("B-heap", n);
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ * Benchmark: loading the scheduler one insert at a time vs. with
+ * bulk_load, for both the persistent (leftist) scheduler heap and
+ * the array-backed binary heap.
+ *
+ * "sorted" input mimics getPendingTasks (ORDER BY priority,
+ * created_at); "shuffled" input exercises the heapify path. Every
+ * heap is then drained a little to check it is well-formed.
+ *
+ * Usage: bulk_load_bench [num_tasks ...]   (default 1,000,000 10,000,000)
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "../data_structures/PersistentPriorityQueue.h"
+#include "../data_structures/PriorityQueue.h"
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Pops a few thousand entries and checks they come out in order
+template <typename Queue>
+static bool drains_in_order(Queue& queue) {
+    int last = 0;
+    for (int i = 0; i < 10000 && !queue.isEmpty(); i++) {
+        int priority = queue.extract_min().first;
+        if (priority < last) return false;
+        last = priority;
+    }
+    return true;
+}
+
+template <typename Queue>
+static void run(const char* name, const std::vector<std::pair<int, int>>& input) {
+    double insert_s, bulk_s;
+    bool ok = true;
+    {
+        Queue queue;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& item : input) {
+            queue.insert(item.second, item.first);
+        }
+        insert_s = seconds_since(start);
+        ok = ok && drains_in_order(queue);
+    }
+    {
+        Queue queue;
+        std::vector<std::pair<int, int>> copy = input; // Not timed
+        auto start = std::chrono::steady_clock::now();
+        queue.bulk_load(std::move(copy));
+        bulk_s = seconds_since(start);
+        ok = ok && queue.size() == (int)input.size() && drains_in_order(queue);
+    }
+    std::cout << "  " << name << ": insert " << insert_s << " s, bulk_load " << bulk_s << " s ("
+              << insert_s / bulk_s << "x)" << (ok ? "" : "  ** ORDER CHECK FAILED **") << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::vector<long> sizes;
+    for (int i = 1; i < argc; i++) sizes.push_back(std::atol(argv[i]));
+    if (sizes.empty()) sizes = {1000000L, 10000000L};
+
+    std::mt19937 rng(42);
+    for (long n : sizes) {
+        std::vector<std::pair<int, int>> sorted;
+        sorted.reserve(n);
+        for (long i = 0; i < n; i++) {
+            sorted.emplace_back(1 + (int)(rng() % 5), (int)i);
+        }
+        std::stable_sort(sorted.begin(), sorted.end(),
+                         [](const std::pair<int, int>& a, const std::pair<int, int>& b) { return a.first < b.first; });
+        std::vector<std::pair<int, int>> shuffled = sorted;
+        std::shuffle(shuffled.begin(), shuffled.end(), rng);
+
+        std::cout << n << " tasks, sorted input:" << std::endl;
+        run<PersistentPriorityQueue<int, int>>("PersistentPriorityQueue", sorted);
+        run<PriorityQueue<int, int>>("PriorityQueue          ", sorted);
+        std::cout << n << " tasks, shuffled input:" << std::endl;
+        run<PersistentPriorityQueue<int, int>>("PersistentPriorityQueue", shuffled);
+        run<PriorityQueue<int, int>>("PriorityQueue          ", shuffled);
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+/*
+ * Benchmark: FullTextIndex build time, compressed size and query
+ * latency over synthetic task titles/descriptions.
+ *
+ * Words are drawn from a skewed (roughly Zipfian) vocabulary so a
+ * few terms are very common and most are rare, like real tickets.
+ *
+ * Usage: fulltext_bench [num_tasks]   (default 10,000,000)
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "../cache/FullTextIndex.h"
+
+static double micros_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    long num_tasks = argc > 1 ? std::atol(argv[1]) : 10000000L;
+
+    // Vocabulary: a few hundred "real" words plus numbered rare ones
+    std::vector<std::string> vocab = {"fix", "bug", "login", "deploy", "prod", "update", "docs", "api",
+                                      "refactor", "legacy", "code", "email", "team", "meeting", "crash",
+                                      "page", "database", "migration", "timeout", "cache", "signup",
+                                      "payment", "report", "dashboard", "release", "hotfix", "review"};
+    for (int i = 0; i < 50000; i++) {
+        vocab.push_back("term" + std::to_string(i));
+    }
+
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> uni(0.0, 1.0);
+    auto pick = [&]() -> const std::string& {
+        // Inverse-power sampling gives a heavy head and a long tail
+        std::size_t i = (std::size_t)(std::pow(uni(rng), 3.0) * vocab.size());
+        return vocab[std::min(i, vocab.size() - 1)];
+    };
+
+    FullTextIndex index;
+    auto start = std::chrono::steady_clock::now();
+    for (long id = 1; id <= num_tasks; id++) {
+        std::string title = pick() + " " + pick() + " " + pick();
+        std::string desc = pick() + " " + pick() + " " + pick() + " " + pick() + " " + pick();
+        index.add((int)id, title, desc);
+    }
+    double build_s = micros_since(start) / 1e6;
+
+    std::cout << "Indexed " << num_tasks << " tasks in " << build_s << " s ("
+              << (long long)(num_tasks / build_s) << " tasks/s)" << std::endl;
+    std::cout << "  terms: " << index.terms() << ", posting bytes: " << index.posting_bytes()
+              << " (" << (double)index.posting_bytes() / num_tasks << " bytes/task)" << std::endl;
+
+    const char* queries[] = {"fix", "login crash", "fix bug login", "deploy OR hotfix", "term4999",
+                             "term49 term12", "migr*", "term123*", "payment timeout OR signup crash"};
+    for (const char* q : queries) {
+        const int RUNS = 5;
+        std::size_t hits = 0;
+        double best = 1e18;
+        for (int r = 0; r < RUNS; r++) {
+            auto t0 = std::chrono::steady_clock::now();
+            hits = index.search(q).size();
+            best = std::min(best, micros_since(t0));
+        }
+        std::cout << "  query \"" << q << "\": " << hits << " hits, best of " << RUNS << ": "
+                  << best << " us" << std::endl;
+    }
+    return 0;
+}
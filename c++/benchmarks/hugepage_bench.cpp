@@ -0,0 +1,115 @@
+/*
+ * Benchmark: Task working set on the general heap vs. a HugePageArena
+ * with regular pages vs. a HugePageArena with huge pages.
+ *
+ * Each run allocates num_tasks Tasks, builds a binary heap of Task*
+ * keyed on priority (like the scheduler does), then does random
+ * lookups across the whole set and drains the heap. The random
+ * pointer chasing is what makes TLB reach matter.
+ *
+ * dTLB load misses are read with perf_event_open; they print as "n/a"
+ * when the kernel does not allow it (see perf_event_paranoid).
+ *
+ * Usage: hugepage_bench [num_tasks]   (default 5,000,000)
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "../data_structures/HugePageArena.h"
+#include "../models/Task.h"
+#include "PerfCounter.h"
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+struct ByPriority {
+    bool operator()(const Task* a, const Task* b) const {
+        if (a->priority != b->priority) return a->priority > b->priority;
+        return a->task_id > b->task_id;
+    }
+};
+
+// Heap build + random lookups + drain over an already-allocated set
+template <typename Vec>
+static void run_workload(const char* label, Vec& heap, long num_tasks, const std::string& alloc_note,
+                         double alloc_s) {
+    PerfCounter tlb = PerfCounter::dtlb_misses();
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<std::size_t> any(0, heap.size() - 1);
+
+    tlb.start();
+    auto start = std::chrono::steady_clock::now();
+
+    std::make_heap(heap.begin(), heap.end(), ByPriority());
+    long long checksum = 0;
+    for (long i = 0; i < num_tasks; i++) {
+        const Task* t = heap[any(rng)];
+        checksum += t->priority + t->assignee_id + (long long)t->title.size();
+    }
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), ByPriority());
+        checksum += heap.back()->task_id & 1;
+        heap.pop_back();
+    }
+
+    double work_s = seconds_since(start);
+    std::string misses = tlb.stop();
+
+    std::cout << label << " [" << alloc_note << "]" << std::endl;
+    std::cout << "  allocate: " << alloc_s << " s, workload: " << work_s << " s ("
+              << (long long)(num_tasks / work_s) << " tasks/s), dTLB misses: " << misses
+              << " (checksum " << checksum << ")" << std::endl;
+}
+
+static Task* fill(Task* t, long id, std::mt19937& rng) {
+    t->task_id = (int)id;
+    t->assignee_id = (int)(rng() % 1000);
+    t->priority = 1 + (int)(rng() % 5);
+    t->title = "task " + std::to_string(id);
+    return t;
+}
+
+int main(int argc, char** argv) {
+    long num_tasks = argc > 1 ? std::atol(argv[1]) : 5000000L;
+    std::cout << "Tasks: " << num_tasks << ", sizeof(Task): " << sizeof(Task) << " bytes" << std::endl;
+
+    // 1. General heap (new/delete)
+    {
+        std::mt19937 rng(42);
+        std::vector<std::unique_ptr<Task>> owned;
+        std::vector<Task*> heap;
+        owned.reserve(num_tasks);
+        heap.reserve(num_tasks);
+        auto start = std::chrono::steady_clock::now();
+        for (long id = 1; id <= num_tasks; id++) {
+            owned.emplace_back(fill(new Task(), id, rng));
+            heap.push_back(owned.back().get());
+        }
+        run_workload("new/delete", heap, num_tasks, "malloc", seconds_since(start));
+    }
+
+    // 2 & 3. Arena with regular pages, then the best huge-page source
+    HugePageArena::PageMode modes[] = {HugePageArena::PageMode::Regular, HugePageArena::PageMode::Auto};
+    for (HugePageArena::PageMode mode : modes) {
+        std::mt19937 rng(42);
+        HugePageArena arena(256 * 1024 * 1024, mode);
+        ArenaVector<Task*> heap{ArenaAllocator<Task*>(arena)};
+        heap.reserve(num_tasks);
+        auto start = std::chrono::steady_clock::now();
+        for (long id = 1; id <= num_tasks; id++) {
+            heap.push_back(fill(arena.create<Task>(), id, rng));
+        }
+        double alloc_s = seconds_since(start);
+        std::string note = std::string(HugePageArena::mode_name(arena.mode())) + " pages, " +
+                           std::to_string(arena.bytes_reserved() >> 20) + " MB reserved";
+        run_workload(mode == HugePageArena::PageMode::Regular ? "arena (4KB)" : "arena (2MB)", heap,
+                     num_tasks, note, alloc_s);
+    }
+    return 0;
+}
@@ -0,0 +1,236 @@
+#include "FullTextIndex.h"
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <mutex>
+
+// --- Varint helpers ---
+
+static void put_varint(std::vector<std::uint8_t>& out, std::uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back((std::uint8_t)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((std::uint8_t)v);
+}
+
+static std::uint32_t get_varint(const std::uint8_t*& p) {
+    std::uint32_t v = 0;
+    int shift = 0;
+    while (*p & 0x80) {
+        v |= (std::uint32_t)(*p++ & 0x7F) << shift;
+        shift += 7;
+    }
+    v |= (std::uint32_t)(*p++) << shift;
+    return v;
+}
+
+static std::vector<int> merge_union(const std::vector<int>& a, const std::vector<int>& b) {
+    std::vector<int> out;
+    out.reserve(a.size() + b.size());
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(out));
+    return out;
+}
+
+// --- PostingList ---
+
+bool FullTextIndex::PostingList::append(std::uint32_t id) {
+    if (count > 0 && id == last_id) {
+        return false; // Already indexed
+    }
+    if (count == 0 || id > last_id) {
+        put_varint(bytes, count == 0 ? id : id - last_id);
+        last_id = id;
+        count++;
+        return true;
+    }
+
+    // Out-of-order id (rare): decode, insert, re-encode
+    std::vector<int> ids = decode();
+    auto it = std::lower_bound(ids.begin(), ids.end(), (int)id);
+    if (it != ids.end() && *it == (int)id) {
+        return false;
+    }
+    ids.insert(it, (int)id);
+    bytes.clear();
+    std::uint32_t prev = 0;
+    for (int v : ids) {
+        put_varint(bytes, (std::uint32_t)v - prev);
+        prev = (std::uint32_t)v;
+    }
+    count++;
+    return true;
+}
+
+std::vector<int> FullTextIndex::PostingList::decode() const {
+    std::vector<int> ids;
+    ids.reserve(count);
+    const std::uint8_t* p = bytes.data();
+    std::uint32_t id = 0;
+    for (std::uint32_t i = 0; i < count; i++) {
+        id += get_varint(p);
+        ids.push_back((int)id);
+    }
+    return ids;
+}
+
+// --- Indexing ---
+
+std::vector<std::string> FullTextIndex::tokenize(const std::string& text) {
+    std::vector<std::string> tokens;
+    std::string current;
+    for (char ch : text) {
+        unsigned char c = (unsigned char)ch;
+        if (std::isalnum(c)) {
+            if (current.size() < MAX_TERM_LENGTH) {
+                current.push_back((char)std::tolower(c));
+            }
+        } else if (!current.empty()) {
+            tokens.push_back(current);
+            current.clear();
+        }
+    }
+    if (!current.empty()) {
+        tokens.push_back(current);
+    }
+    return tokens;
+}
+
+void FullTextIndex::add(int task_id, const std::string& title, const std::string& description) {
+    if (task_id <= 0) {
+        return;
+    }
+    std::vector<std::string> terms = tokenize(title);
+    std::vector<std::string> desc_terms = tokenize(description);
+    terms.insert(terms.end(), desc_terms.begin(), desc_terms.end());
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    for (const std::string& term : terms) {
+        postings[term].append((std::uint32_t)task_id);
+    }
+    documents_indexed.append((std::uint32_t)task_id);
+}
+
+// --- Queries ---
+
+std::vector<int> FullTextIndex::lookup(const std::string& term) const {
+    auto it = postings.find(term);
+    return it == postings.end() ? std::vector<int>() : it->second.decode();
+}
+
+std::vector<int> FullTextIndex::lookup_prefix(const std::string& prefix) const {
+    // Concatenate every matching list, then sort once
+    std::vector<int> result;
+    for (auto it = postings.lower_bound(prefix);
+         it != postings.end() && it->first.compare(0, prefix.size(), prefix) == 0; ++it) {
+        std::vector<int> ids = it->second.decode();
+        result.insert(result.end(), ids.begin(), ids.end());
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+// AND of terms; a trailing '*' marks a prefix term
+std::vector<int> FullTextIndex::evaluate_all(const std::vector<std::string>& terms) const {
+    // Fetch every list first so we can intersect smallest-first
+    std::vector<std::vector<int>> lists;
+    for (const std::string& term : terms) {
+        bool prefix = !term.empty() && term.back() == '*';
+        std::vector<std::string> words = tokenize(prefix ? term.substr(0, term.size() - 1) : term);
+        if (words.empty()) continue;
+        for (std::size_t i = 0; i < words.size(); i++) {
+            bool last = i + 1 == words.size();
+            lists.push_back(prefix && last ? lookup_prefix(words[i]) : lookup(words[i]));
+            if (lists.back().empty()) {
+                return std::vector<int>(); // One empty list empties the AND
+            }
+        }
+    }
+    if (lists.empty()) {
+        return std::vector<int>();
+    }
+    std::sort(lists.begin(), lists.end(),
+              [](const std::vector<int>& a, const std::vector<int>& b) { return a.size() < b.size(); });
+
+    std::vector<int> result = lists[0];
+    for (std::size_t i = 1; i < lists.size() && !result.empty(); i++) {
+        std::vector<int> next;
+        std::set_intersection(result.begin(), result.end(), lists[i].begin(), lists[i].end(),
+                              std::back_inserter(next));
+        result.swap(next);
+    }
+    return result;
+}
+
+std::vector<int> FullTextIndex::search_all(const std::vector<std::string>& terms) const {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    return evaluate_all(terms);
+}
+
+std::vector<int> FullTextIndex::search_any(const std::vector<std::string>& terms) const {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    std::vector<int> result;
+    for (const std::string& term : terms) {
+        result = merge_union(result, evaluate_all({term}));
+    }
+    return result;
+}
+
+std::vector<int> FullTextIndex::search_prefix(const std::string& prefix) const {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    std::vector<std::string> words = tokenize(prefix);
+    return words.empty() ? std::vector<int>() : lookup_prefix(words[0]);
+}
+
+std::vector<int> FullTextIndex::search(const std::string& query) const {
+    // Split on whitespace into OR-separated groups of AND terms
+    std::vector<std::vector<std::string>> groups(1);
+    std::string word;
+    auto flush = [&]() {
+        if (word == "OR") {
+            groups.emplace_back();
+        } else if (!word.empty()) {
+            groups.back().push_back(word);
+        }
+        word.clear();
+    };
+    for (char ch : query) {
+        if (std::isspace((unsigned char)ch)) {
+            flush();
+        } else {
+            word.push_back(ch);
+        }
+    }
+    flush();
+
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    std::vector<int> result;
+    for (const auto& group : groups) {
+        if (!group.empty()) {
+            result = merge_union(result, evaluate_all(group));
+        }
+    }
+    return result;
+}
+
+std::size_t FullTextIndex::documents() const {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    return documents_indexed.count;
+}
+
+std::size_t FullTextIndex::terms() const {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    return postings.size();
+}
+
+std::size_t FullTextIndex::posting_bytes() const {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    std::size_t bytes = 0;
+    for (const auto& entry : postings) {
+        bytes += entry.second.bytes.size();
+    }
+    return bytes;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+/*
+ * In-process inverted index over task titles and descriptions, to
+ * replace `LIKE '%...%'` table scans.
+ *
+ * Each term maps to a posting list of the task ids containing it.
+ * Posting lists are stored as delta + varint encoded bytes: ids
+ * arrive (mostly) in ascending order, so each entry is the gap to
+ * the previous id, usually 1-2 bytes instead of 4.
+ *
+ * Query syntax (case-insensitive):
+ *   login bug        -> tasks containing "login" AND "bug"
+ *   login OR signup  -> either term
+ *   deploy*          -> any term starting with "deploy"
+ * AND binds tighter than OR: "a b OR c" means (a AND b) OR c.
+ *
+ * Terms are cut to their first MAX_TERM_LENGTH characters, both when
+ * indexing and in queries, so two long terms sharing that prefix are
+ * the same term to the index.
+ */
+class FullTextIndex {
+public:
+    static const std::size_t MAX_TERM_LENGTH = 32;
+
+    // Splits text into lowercase alphanumeric terms of at most MAX_TERM_LENGTH
+    static std::vector<std::string> tokenize(const std::string& text);
+
+    // Indexes the terms of one task. Adding the same id twice is harmless.
+    void add(int task_id, const std::string& title, const std::string& description);
+
+    // Sorted, de-duplicated ids matching the query
+    std::vector<int> search(const std::string& query) const;
+
+    std::vector<int> search_all(const std::vector<std::string>& terms) const; // AND
+    std::vector<int> search_any(const std::vector<std::string>& terms) const; // OR
+    std::vector<int> search_prefix(const std::string& prefix) const;
+
+    std::size_t documents() const;
+    std::size_t terms() const;
+    std::size_t posting_bytes() const; // Compressed size of all posting lists
+
+private:
+    struct PostingList {
+        std::vector<std::uint8_t> bytes; // Delta + varint encoded ids
+        std::uint32_t last_id = 0;
+        std::uint32_t count = 0;
+
+        bool append(std::uint32_t id); // False if the id was already there
+        std::vector<int> decode() const;
+    };
+
+    mutable std::shared_mutex mtx;
+    std::map<std::string, PostingList> postings; // Ordered, for prefix scans
+    PostingList documents_indexed; // Every id passed to add()
+
+    // Require at least a shared lock
+    std::vector<int> lookup(const std::string& term) const;
+    std::vector<int> lookup_prefix(const std::string& prefix) const;
+    std::vector<int> evaluate_all(const std::vector<std::string>& terms) const;
+};
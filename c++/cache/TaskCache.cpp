@@ -0,0 +1,198 @@
+#include "TaskCache.h"
+#include <algorithm>
+#include <mutex>
+
+// --- Incremental maintenance ---
+
+void TaskCache::index(const Task& task) {
+    std::vector<int>& ids = by_assignee[task.assignee_id];
+    // New ids are auto-increment, so this is almost always an append
+    if (ids.empty() || ids.back() < task.task_id) {
+        ids.push_back(task.task_id);
+    } else {
+        auto it = std::lower_bound(ids.begin(), ids.end(), task.task_id);
+        if (it == ids.end() || *it != task.task_id) {
+            ids.insert(it, task.task_id);
+        }
+    }
+    by_status[task.status].add((std::uint32_t)task.task_id);
+}
+
+void TaskCache::unindex(const Task& task) {
+    auto a = by_assignee.find(task.assignee_id);
+    if (a != by_assignee.end()) {
+        std::vector<int>& ids = a->second;
+        auto it = std::lower_bound(ids.begin(), ids.end(), task.task_id);
+        if (it != ids.end() && *it == task.task_id) {
+            ids.erase(it);
+        }
+        if (ids.empty()) {
+            by_assignee.erase(a);
+        }
+    }
+    auto s = by_status.find(task.status);
+    if (s != by_status.end()) {
+        s->second.remove((std::uint32_t)task.task_id);
+    }
+}
+
+void TaskCache::onTaskCreated(const Task& task) {
+    upsert(task);
+}
+
+void TaskCache::upsert(const Task& task) {
+    if (task.task_id <= 0) {
+        return; // Not persisted yet
+    }
+    bool is_new = false;
+    {
+        std::unique_lock<std::shared_mutex> lock(mtx);
+        auto it = tasks.find(task.task_id);
+        if (it != tasks.end()) {
+            unindex(it->second);
+            it->second = task;
+        } else {
+            tasks.emplace(task.task_id, task);
+            is_new = true;
+        }
+        index(task);
+    }
+    // Titles and descriptions never change once created
+    if (is_new) {
+        text_index.add(task.task_id, task.title, task.description);
+    }
+}
+
+void TaskCache::onStatusChanged(int task_id, const std::string& old_status, const std::string& new_status) {
+    std::unique_lock<std::shared_mutex> lock(mtx);
+    auto it = tasks.find(task_id);
+    if (it == tasks.end()) {
+        return; // Not cached; nothing to keep consistent
+    }
+    // Trust the cached row over old_status if they ever disagree
+    (void)old_status;
+    by_status[it->second.status].remove((std::uint32_t)task_id);
+    it->second.status = new_status;
+    by_status[new_status].add((std::uint32_t)task_id);
+}
+
+// --- Queries ---
+
+std::vector<int> TaskCache::taskIdsByAssignee(int assignee_id, const std::string& status) const {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    std::vector<int> result;
+    auto a = by_assignee.find(assignee_id);
+    if (a == by_assignee.end()) {
+        return result;
+    }
+    if (status.empty()) {
+        return a->second;
+    }
+    auto s = by_status.find(status);
+    if (s == by_status.end()) {
+        return result;
+    }
+    // Probe the (usually much larger) status bitmap for each of the
+    // assignee's ids: O(k) for k tasks assigned to this user
+    for (int id : a->second) {
+        if (s->second.contains((std::uint32_t)id)) {
+            result.push_back(id);
+        }
+    }
+    return result;
+}
+
+std::vector<int> TaskCache::taskIdsByStatus(const std::string& status) const {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    std::vector<int> result;
+    auto s = by_status.find(status);
+    if (s != by_status.end()) {
+        result.reserve(s->second.cardinality());
+        s->second.for_each([&result](std::uint32_t id) { result.push_back((int)id); });
+    }
+    return result;
+}
+
+std::size_t TaskCache::countByStatus(const std::string& status) const {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    auto s = by_status.find(status);
+    return s == by_status.end() ? 0 : s->second.cardinality();
+}
+
+std::vector<Task> TaskCache::tasksByAssignee(int assignee_id, const std::string& status) const {
+    return rows(taskIdsByAssignee(assignee_id, status));
+}
+
+std::vector<Task> TaskCache::topTasksByStatus(const std::string& status, std::size_t k) const {
+    std::vector<Task> result;
+    if (k == 0) {
+        return result;
+    }
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    auto s = by_status.find(status);
+    if (s == by_status.end()) {
+        return result;
+    }
+
+    // Max-heap on (priority, id): the root is the worst of the best k,
+    // so each candidate is compared against it in O(1)
+    typedef std::pair<int, int> Key; // (priority, task_id)
+    std::vector<Key> heap;
+    heap.reserve(k);
+    s->second.for_each([&](std::uint32_t id) {
+        auto it = tasks.find((int)id);
+        if (it == tasks.end()) return;
+        Key key(it->second.priority, (int)id);
+        if (heap.size() < k) {
+            heap.push_back(key);
+            std::push_heap(heap.begin(), heap.end());
+        } else if (key < heap.front()) {
+            std::pop_heap(heap.begin(), heap.end());
+            heap.back() = key;
+            std::push_heap(heap.begin(), heap.end());
+        }
+    });
+
+    std::sort_heap(heap.begin(), heap.end()); // Ascending: best first
+    result.reserve(heap.size());
+    for (const Key& key : heap) {
+        result.push_back(tasks.at(key.second));
+    }
+    return result;
+}
+
+std::vector<int> TaskCache::searchIds(const std::string& query) const {
+    return text_index.search(query);
+}
+
+std::vector<Task> TaskCache::searchTasks(const std::string& query) const {
+    return rows(text_index.search(query));
+}
+
+std::vector<Task> TaskCache::rows(const std::vector<int>& ids) const {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    std::vector<Task> result;
+    result.reserve(ids.size());
+    for (int id : ids) {
+        auto it = tasks.find(id);
+        if (it != tasks.end()) { // May have changed since we read the index
+            result.push_back(it->second);
+        }
+    }
+    return result;
+}
+
+bool TaskCache::getTask(int task_id, Task& out) const {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    auto it = tasks.find(task_id);
+    if (it == tasks.end()) {
+        return false;
+    }
+    out = it->second;
+    return true;
+}
+
+std::size_t TaskCache::size() const {
+    std::shared_lock<std::shared_mutex> lock(mtx);
+    return tasks.size();
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstddef>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../models/Task.h"
+#include "../data_structures/CompressedBitmap.h"
+#include "FullTextIndex.h"
+
+/*
+ * In-process cache of Task rows with secondary indexes, so questions
+ * like "all in_progress tasks for user 42" are answered in
+ * microseconds without a DB round trip.
+ *
+ * Indexes:
+ * - assignee_id -> sorted vector of task ids
+ * - status      -> CompressedBitmap of task ids
+ * - title/description terms -> FullTextIndex (keyword search)
+ *
+ * The cache is kept up to date incrementally: DatabaseConnector
+ * calls onTaskCreated / onStatusChanged after each successful
+ * createTask / updateTaskStatus. Rows created elsewhere can be
+ * loaded with upsert().
+ *
+ * Reads take a shared lock, updates an exclusive one.
+ */
+class TaskCache {
+public:
+    // --- Incremental maintenance ---
+    void onTaskCreated(const Task& task);
+    void onStatusChanged(int task_id, const std::string& old_status, const std::string& new_status);
+    void upsert(const Task& task);
+
+    // --- Queries ---
+
+    // Sorted task ids. An empty `status` means any status.
+    std::vector<int> taskIdsByAssignee(int assignee_id, const std::string& status = "") const;
+    std::vector<int> taskIdsByStatus(const std::string& status) const;
+    std::size_t countByStatus(const std::string& status) const;
+
+    // Copies of the cached rows, sorted by task id
+    std::vector<Task> tasksByAssignee(int assignee_id, const std::string& status = "") const;
+
+    // The k highest-priority tasks with `status`, ordered by
+    // (priority, task_id) like getPendingTasks orders by
+    // (priority, created_at). Keeps a bounded heap of k entries
+    // instead of sorting every match.
+    // Complexity: O(n log k) for n tasks with that status
+    std::vector<Task> topTasksByStatus(const std::string& status, std::size_t k) const;
+
+    // Keyword search over titles and descriptions (see FullTextIndex
+    // for the query syntax). Ids are sorted.
+    std::vector<int> searchIds(const std::string& query) const;
+    std::vector<Task> searchTasks(const std::string& query) const;
+
+    // Returns false if the task isn't cached
+    bool getTask(int task_id, Task& out) const;
+
+    std::size_t size() const;
+
+private:
+    mutable std::shared_mutex mtx;
+    std::unordered_map<int, Task> tasks;
+    std::unordered_map<int, std::vector<int>> by_assignee;
+    std::map<std::string, CompressedBitmap> by_status;
+    FullTextIndex text_index; // Has its own lock
+
+    // Copies of the cached rows for `ids` (takes a shared lock)
+    std::vector<Task> rows(const std::vector<int>& ids) const;
+
+    // Require the exclusive lock
+    void index(const Task& task);
+    void unindex(const Task& task);
+};
@@ -0,0 +1,235 @@
+#pragma once
+#include "Queue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <memory_resource> // For std::pmr::polymorphic_allocator
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/*
+ * Thread-safe FIFO queue whose consumers can block until work
+ * arrives, instead of polling isEmpty() and sleeping. Header-only.
+ *
+ * Wrapped around our Queue<T, Alloc>, so nodes come from the same
+ * allocator (e.g. a pool) and are only touched under `mutex`.
+ *
+ * Waiting is spin-then-park: a consumer that finds the queue empty
+ * first spins for a few microseconds on an atomic count (cheap if
+ * work is about to arrive), then parks on a condition variable
+ * (a futex on Linux), using no CPU until it is woken.
+ *
+ * Wakeups are coalesced: a producer only signals when there are
+ * parked consumers that have not already been signalled, so a burst
+ * of pushes wakes each sleeper once rather than once per item. A
+ * consumer that wakes and leaves work behind passes the baton to the
+ * next sleeper. push_all() wakes at most one consumer per item.
+ *
+ * close() wakes everyone; waits then return nothing once the queue
+ * is drained, so workers can shut down cleanly.
+ *
+ * Analogy: A restaurant pass. Cooks put plates up and ring the bell
+ * only if a waiter is standing around, not once per plate.
+ */
+template <typename T, typename Alloc = std::allocator<T>>
+class BlockingQueue {
+private:
+    Queue<T, Alloc> items;
+    mutable std::mutex mutex;
+    std::condition_variable not_empty;
+    std::size_t waiting;          // Consumers parked in not_empty
+    std::size_t wakeups_pending;  // Signals sent but not yet consumed
+    bool closed;
+    std::atomic<std::size_t> available; // Mirrors items.size() for spinning readers
+    std::atomic<bool> closed_flag;
+    int spin_iterations;
+
+    static void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+    // Spin briefly before taking the lock and parking
+    void spin() const {
+        for (int i = 0; i < spin_iterations; i++) {
+            if (available.load(std::memory_order_acquire) > 0 || closed_flag.load(std::memory_order_acquire)) {
+                return;
+            }
+            cpu_relax();
+        }
+    }
+
+    // How many parked consumers to signal for `n` new items (lock held)
+    std::size_t reserve_wakeups(std::size_t n) {
+        std::size_t idle = waiting > wakeups_pending ? waiting - wakeups_pending : 0;
+        std::size_t to_wake = n < idle ? n : idle;
+        wakeups_pending += to_wake;
+        return to_wake;
+    }
+
+    // Signal outside the lock so the woken thread can take it at once
+    void wake(std::size_t to_wake) {
+        if (to_wake == 1) {
+            not_empty.notify_one();
+        } else if (to_wake > 1) {
+            for (std::size_t i = 0; i < to_wake; i++) not_empty.notify_one();
+        }
+    }
+
+    // Park until there is an item, the queue is closed, or `deadline`
+    // passes. Returns true if an item is available (lock held).
+    bool wait_locked(std::unique_lock<std::mutex>& lock, bool timed, std::chrono::steady_clock::time_point deadline) {
+        while (items.isEmpty() && !closed) {
+            waiting++;
+            bool timed_out = false;
+            if (timed) {
+                timed_out = not_empty.wait_until(lock, deadline) == std::cv_status::timeout;
+            } else {
+                not_empty.wait(lock);
+            }
+            waiting--;
+            if (wakeups_pending > 0) wakeups_pending--;
+            if (timed_out) break;
+        }
+        return !items.isEmpty();
+    }
+
+    std::optional<T> pop_impl(bool timed, std::chrono::steady_clock::time_point deadline) {
+        if (available.load(std::memory_order_acquire) == 0) {
+            spin();
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!wait_locked(lock, timed, deadline)) {
+            return std::nullopt;
+        }
+        std::optional<T> item(items.dequeue());
+        available.store(items.size(), std::memory_order_release);
+        std::size_t to_wake = items.isEmpty() ? 0 : reserve_wakeups(1); // Pass the baton
+        lock.unlock();
+        wake(to_wake);
+        return item;
+    }
+
+public:
+    static const int DEFAULT_SPIN = 2000; // ~ a few microseconds
+
+    explicit BlockingQueue(const Alloc& a = Alloc(), int spin = DEFAULT_SPIN)
+        : items(a), waiting(0), wakeups_pending(0), closed(false), available(0), closed_flag(false),
+          spin_iterations(std::thread::hardware_concurrency() > 1 ? spin : 0) {}
+
+    BlockingQueue(const BlockingQueue&) = delete;
+    BlockingQueue& operator=(const BlockingQueue&) = delete;
+
+    // Add an item to the back and wake a parked consumer if needed
+    // Complexity: O(1)
+    void push(T item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        items.enqueue(std::move(item));
+        available.store(items.size(), std::memory_order_release);
+        std::size_t to_wake = reserve_wakeups(1);
+        lock.unlock();
+        wake(to_wake);
+    }
+
+    // Add a whole batch under one lock; `batch` is left empty.
+    // Complexity: O(m)
+    void push_all(std::vector<T>& batch) {
+        if (batch.empty()) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        for (T& item : batch) {
+            items.enqueue(std::move(item));
+        }
+        available.store(items.size(), std::memory_order_release);
+        std::size_t to_wake = reserve_wakeups(batch.size());
+        lock.unlock();
+        batch.clear();
+        wake(to_wake);
+    }
+
+    // Take the front item if there is one, without waiting
+    bool try_pop(T& out) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (items.isEmpty()) {
+            return false;
+        }
+        out = items.dequeue();
+        available.store(items.size(), std::memory_order_release);
+        return true;
+    }
+
+    // Wait as long as it takes. Empty only once closed and drained.
+    std::optional<T> pop_wait() {
+        return pop_impl(false, std::chrono::steady_clock::time_point());
+    }
+
+    // Wait at most `timeout`. Empty on timeout, or once closed and drained.
+    template <typename Rep, typename Period>
+    std::optional<T> pop_wait_for(const std::chrono::duration<Rep, Period>& timeout) {
+        return pop_impl(true, std::chrono::steady_clock::now() + timeout);
+    }
+
+    /*
+     * Wait up to `timeout` for at least one item, then take up to
+     * `max_items` in one go (appended to `out`). Amortizes locking for
+     * consumers that work in batches. Returns how many were taken.
+     */
+    template <typename Rep, typename Period>
+    std::size_t pop_bulk(std::vector<T>& out, std::size_t max_items, const std::chrono::duration<Rep, Period>& timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        if (available.load(std::memory_order_acquire) == 0) {
+            spin();
+        }
+        std::unique_lock<std::mutex> lock(mutex);
+        if (!wait_locked(lock, true, deadline)) {
+            return 0;
+        }
+        std::size_t taken = 0;
+        while (taken < max_items && !items.isEmpty()) {
+            out.push_back(items.dequeue());
+            taken++;
+        }
+        available.store(items.size(), std::memory_order_release);
+        std::size_t to_wake = items.isEmpty() ? 0 : reserve_wakeups(1);
+        lock.unlock();
+        wake(to_wake);
+        return taken;
+    }
+
+    // Wake every waiter; no more waiting once the queue is drained.
+    // Items can still be pushed and popped.
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+            closed_flag.store(true, std::memory_order_release);
+        }
+        not_empty.notify_all();
+    }
+
+    bool isClosed() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return closed;
+    }
+
+    bool isEmpty() const {
+        return available.load(std::memory_order_acquire) == 0;
+    }
+
+    int size() const {
+        return (int)available.load(std::memory_order_acquire);
+    }
+};
+
+// BlockingQueue whose nodes come from a std::pmr::memory_resource
+template <typename T>
+using PmrBlockingQueue = BlockingQueue<T, std::pmr::polymorphic_allocator<T>>;
@@ -0,0 +1,185 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Compressed bitmap of 32-bit ids (a simplified "Roaring" bitmap).
+ *
+ * Ids are split by their high 16 bits into containers. Each
+ * container stores its low 16 bits either as
+ * - a sorted array of uint16_t (sparse: up to 4096 ids, 2 bytes each), or
+ * - a 65536-bit bitset (dense: a fixed 8KB).
+ * A container switches representation when it crosses 4096 ids, so
+ * memory stays close to min(2 bytes/id, 1 bit/id) of the range.
+ *
+ * Analogy: A phone book split into sections by area code; small
+ * sections are a short list, huge ones a tick-box for every number.
+ */
+class CompressedBitmap {
+private:
+    static const std::size_t ARRAY_MAX = 4096;
+    static const std::size_t BITSET_WORDS = 65536 / 64;
+
+    struct Container {
+        std::uint16_t key;                // High 16 bits
+        std::uint32_t cardinality;
+        std::vector<std::uint16_t> array; // Used while sparse
+        std::vector<std::uint64_t> bits;  // Used once dense
+
+        bool is_bitset() const { return !bits.empty(); }
+
+        bool contains(std::uint16_t low) const {
+            if (is_bitset()) {
+                return (bits[low >> 6] >> (low & 63)) & 1;
+            }
+            return std::binary_search(array.begin(), array.end(), low);
+        }
+
+        bool add(std::uint16_t low) {
+            if (is_bitset()) {
+                std::uint64_t mask = (std::uint64_t)1 << (low & 63);
+                if (bits[low >> 6] & mask) return false;
+                bits[low >> 6] |= mask;
+            } else {
+                auto it = std::lower_bound(array.begin(), array.end(), low);
+                if (it != array.end() && *it == low) return false;
+                array.insert(it, low); // Ids mostly arrive in order: usually an append
+                if (array.size() > ARRAY_MAX) to_bitset();
+            }
+            cardinality++;
+            return true;
+        }
+
+        bool remove(std::uint16_t low) {
+            if (is_bitset()) {
+                std::uint64_t mask = (std::uint64_t)1 << (low & 63);
+                if (!(bits[low >> 6] & mask)) return false;
+                bits[low >> 6] &= ~mask;
+                cardinality--;
+                if (cardinality <= ARRAY_MAX / 2) to_array(); // Hysteresis avoids flapping
+            } else {
+                auto it = std::lower_bound(array.begin(), array.end(), low);
+                if (it == array.end() || *it != low) return false;
+                array.erase(it);
+                cardinality--;
+            }
+            return true;
+        }
+
+        void to_bitset() {
+            bits.assign(BITSET_WORDS, 0);
+            for (std::uint16_t low : array) {
+                bits[low >> 6] |= (std::uint64_t)1 << (low & 63);
+            }
+            std::vector<std::uint16_t>().swap(array);
+        }
+
+        void to_array() {
+            array.clear();
+            array.reserve(cardinality);
+            for (std::size_t w = 0; w < BITSET_WORDS; w++) {
+                std::uint64_t word = bits[w];
+                while (word) {
+                    int bit = __builtin_ctzll(word);
+                    array.push_back((std::uint16_t)(w * 64 + bit));
+                    word &= word - 1;
+                }
+            }
+            std::vector<std::uint64_t>().swap(bits);
+        }
+    };
+
+    std::vector<Container> containers; // Sorted by key
+    std::size_t _cardinality;
+
+    std::vector<Container>::iterator find(std::uint16_t key) {
+        return std::lower_bound(containers.begin(), containers.end(), key,
+                                [](const Container& c, std::uint16_t k) { return c.key < k; });
+    }
+
+    std::vector<Container>::const_iterator find(std::uint16_t key) const {
+        return std::lower_bound(containers.begin(), containers.end(), key,
+                                [](const Container& c, std::uint16_t k) { return c.key < k; });
+    }
+
+public:
+    CompressedBitmap() : _cardinality(0) {}
+
+    // Complexity: O(log containers + log 4096) for sparse, O(1) for dense
+    void add(std::uint32_t id) {
+        std::uint16_t key = (std::uint16_t)(id >> 16);
+        auto it = find(key);
+        if (it == containers.end() || it->key != key) {
+            Container c;
+            c.key = key;
+            c.cardinality = 0;
+            it = containers.insert(it, c);
+        }
+        if (it->add((std::uint16_t)(id & 0xFFFF))) {
+            _cardinality++;
+        }
+    }
+
+    void remove(std::uint32_t id) {
+        std::uint16_t key = (std::uint16_t)(id >> 16);
+        auto it = find(key);
+        if (it == containers.end() || it->key != key) return;
+        if (it->remove((std::uint16_t)(id & 0xFFFF))) {
+            _cardinality--;
+            if (it->cardinality == 0) containers.erase(it);
+        }
+    }
+
+    bool contains(std::uint32_t id) const {
+        std::uint16_t key = (std::uint16_t)(id >> 16);
+        auto it = find(key);
+        return it != containers.end() && it->key == key && it->contains((std::uint16_t)(id & 0xFFFF));
+    }
+
+    std::size_t cardinality() const {
+        return _cardinality;
+    }
+
+    bool isEmpty() const {
+        return _cardinality == 0;
+    }
+
+    // Calls visit(id) for every id in ascending order
+    template <typename F>
+    void for_each(F visit) const {
+        for (const Container& c : containers) {
+            std::uint32_t high = (std::uint32_t)c.key << 16;
+            if (c.is_bitset()) {
+                for (std::size_t w = 0; w < BITSET_WORDS; w++) {
+                    std::uint64_t word = c.bits[w];
+                    while (word) {
+                        visit(high | (std::uint32_t)(w * 64 + __builtin_ctzll(word)));
+                        word &= word - 1;
+                    }
+                }
+            } else {
+                for (std::uint16_t low : c.array) {
+                    visit(high | low);
+                }
+            }
+        }
+    }
+
+    std::vector<std::uint32_t> to_vector() const {
+        std::vector<std::uint32_t> ids;
+        ids.reserve(_cardinality);
+        for_each([&ids](std::uint32_t id) { ids.push_back(id); });
+        return ids;
+    }
+
+    // Approximate heap usage, for sizing the cache
+    std::size_t memory_bytes() const {
+        std::size_t bytes = containers.capacity() * sizeof(Container);
+        for (const Container& c : containers) {
+            bytes += c.array.capacity() * sizeof(std::uint16_t) + c.bits.capacity() * sizeof(std::uint64_t);
+        }
+        return bytes;
+    }
+};
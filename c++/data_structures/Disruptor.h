@@ -0,0 +1,163 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept> // For std::runtime_error
+#include <thread>
+#include <vector>
+
+/*
+ * A sequence number on its own cache line, written by one thread and
+ * read by others. -1 means "nothing yet".
+ */
+struct alignas(64) Sequence {
+    std::atomic<std::int64_t> value;
+
+    explicit Sequence(std::int64_t initial = -1) : value(initial) {}
+
+    std::int64_t get() const { return value.load(std::memory_order_acquire); }
+    void set(std::int64_t v) { value.store(v, std::memory_order_release); }
+};
+
+/*
+ * Disruptor-style broadcast ring (after the LMAX Disruptor).
+ * Header-only.
+ *
+ * One producer publishes events into a preallocated ring; every
+ * consumer sees every event, in order, at its own pace. Nothing is
+ * allocated or locked after setup:
+ *
+ * - Entries are constructed once and then overwritten in place, so
+ *   publishing is "claim the next slot, fill it, bump the cursor".
+ * - Each consumer owns a Sequence (the last event it finished). The
+ *   producer won't reuse a slot until every consumer has passed it.
+ * - A consumer's sequence barrier is the cursor plus the sequences of
+ *   the consumers it was added `after`, so pipelines (B only sees an
+ *   event once A is done with it) need no extra queues.
+ * - poll() hands over everything available in one batch and then
+ *   stores the consumer's sequence once.
+ *
+ * Single producer only: claim/publish must come from one thread.
+ * Consumers must all be added before the first publish.
+ *
+ * Analogy: A departures board. It's written once per flight, and each
+ * reader (crew, passengers, ground staff) reads it at their own speed;
+ * a line is only reused when everyone has read it.
+ */
+template <typename E>
+class Disruptor {
+public:
+    class Consumer {
+    private:
+        friend class Disruptor;
+        Sequence sequence;                     // Last event fully handled
+        std::vector<const Sequence*> barrier;  // Cursor + upstream consumers
+        std::int64_t cached_available = -1;    // Consumer-private
+
+    public:
+        std::int64_t position() const { return sequence.get(); }
+    };
+
+private:
+    std::vector<E> entries;
+    std::size_t mask;
+    Sequence cursor;                 // Last published event
+    std::int64_t next_seq;           // Producer-private
+    std::int64_t cached_gate;        // Producer's view of the slowest consumer
+    std::vector<std::unique_ptr<Consumer>> consumers;
+
+    // The slowest consumer's position (or everything, with no consumers)
+    std::int64_t min_gate() const {
+        std::int64_t gate = next_seq - 1;
+        for (const auto& c : consumers) {
+            gate = std::min(gate, c->sequence.get());
+        }
+        return gate;
+    }
+
+    static std::size_t round_up_pow2(std::size_t n) {
+        std::size_t cap = 1;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+public:
+    // `capacity` is rounded up to a power of two
+    explicit Disruptor(std::size_t capacity)
+        : entries(round_up_pow2(capacity < 1 ? 1 : capacity)), mask(entries.size() - 1),
+          next_seq(0), cached_gate(-1) {}
+
+    Disruptor(const Disruptor&) = delete;
+    Disruptor& operator=(const Disruptor&) = delete;
+
+    // Register a consumer that sees an event only after every consumer
+    // in `after` has handled it. Must happen before the first publish.
+    Consumer* add_consumer(const std::vector<const Consumer*>& after = {}) {
+        if (next_seq != 0) {
+            throw std::runtime_error("Disruptor consumers must be added before publishing");
+        }
+        std::unique_ptr<Consumer> c(new Consumer());
+        c->barrier.push_back(&cursor);
+        for (const Consumer* upstream : after) {
+            c->barrier.push_back(&upstream->sequence);
+        }
+        consumers.push_back(std::move(c));
+        return consumers.back().get();
+    }
+
+    /*
+     * Producer: wait for a free slot, let `fill` write the event in
+     * place, then make it visible to consumers. Waits (yielding) only
+     * if the slowest consumer is a whole ring behind.
+     * Returns the event's sequence number.
+     */
+    template <typename Fill>
+    std::int64_t publish(Fill&& fill) {
+        std::int64_t wrap_point = next_seq - (std::int64_t)entries.size();
+        while (wrap_point > cached_gate) {
+            cached_gate = min_gate();
+            if (wrap_point > cached_gate) std::this_thread::yield();
+        }
+        fill(entries[(std::size_t)next_seq & mask]);
+        cursor.set(next_seq);
+        return next_seq++;
+    }
+
+    /*
+     * Consumer: run `handler(event, sequence, end_of_batch)` on up to
+     * `max_batch` events that are past this consumer's barrier, then
+     * release them. Returns how many were handled (0 = nothing new).
+     * Each consumer must be polled from one thread at a time.
+     */
+    template <typename Handler>
+    std::size_t poll(Consumer& c, Handler&& handler, std::size_t max_batch = 256) {
+        std::int64_t next = c.sequence.value.load(std::memory_order_relaxed) + 1;
+        if (c.cached_available < next) {
+            std::int64_t available = cursor.get();
+            for (const Sequence* s : c.barrier) {
+                available = std::min(available, s->get());
+            }
+            c.cached_available = available;
+        }
+        if (c.cached_available < next) {
+            return 0;
+        }
+        std::int64_t end = std::min(c.cached_available, next + (std::int64_t)max_batch - 1);
+        for (std::int64_t s = next; s <= end; s++) {
+            handler((const E&)entries[(std::size_t)s & mask], s, s == end);
+        }
+        c.sequence.set(end);
+        return (std::size_t)(end - next + 1);
+    }
+
+    // Sequence of the last published event (-1 = none yet)
+    std::int64_t published() const {
+        return cursor.get();
+    }
+
+    std::size_t capacity() const {
+        return entries.size();
+    }
+};
@@ -0,0 +1,362 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>      // For std::remove
+#include <fstream>
+#include <memory>
+#include <stdexcept>   // For std::runtime_error
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <unistd.h>    // For getpid
+
+/*
+ * Default on-disk encoding for ExternalPriorityQueue payloads:
+ * the raw bytes of a trivially copyable T (a task id, or a small
+ * struct of ids and timestamps). Supply your own codec with the
+ * same two functions for anything else - e.g. one built on
+ * IngestProtocol::encode_record/decode_record for whole Tasks.
+ */
+template <typename T>
+struct TrivialCodec {
+    static_assert(std::is_trivially_copyable<T>::value, "TrivialCodec needs a trivially copyable type");
+
+    static void encode(std::ostream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+    static bool decode(std::istream& in, T& value) {
+        return (bool)in.read(reinterpret_cast<char*>(&value), sizeof(T));
+    }
+};
+
+/*
+ * External-memory Priority Queue for backlogs larger than RAM.
+ * Header-only.
+ *
+ * Keeps at most `memory_limit` entries in an in-memory binary heap.
+ * When that fills up, the entries are sorted and written out as a
+ * "run" file in one sequential pass. extract_min() returns the
+ * smaller of the in-memory minimum and the minimum across all runs.
+ *
+ * The runs are merged lazily with a loser tree (tournament tree):
+ * each run is read front to back through a large buffer, and
+ * replacing the winner costs only log2(runs) comparisons, each
+ * against a single stored "loser". Runs are merged by level: a spill
+ * is level 0, and once `max_fan_in` runs share a level they are
+ * merged into one run of the next level. Every entry is therefore
+ * rewritten O(log_F(N/M)) times rather than on every merge, I/O
+ * stays sequential, and at most (F-1) runs per level are open.
+ *
+ * Same semantics as the other priority queues: lower number =
+ * higher priority, equal priorities come out FIFO. Priorities are
+ * stored raw, so P must be trivially copyable.
+ *
+ * Complexity: insert O(log M) amortized plus O(log_F(N/M) / B) I/O
+ * per entry, where F = max_fan_in and B = entries per I/O buffer;
+ * extract_min O(log M + log k), where M = memory_limit, k = runs.
+ *
+ * Analogy: A library's closed stacks. The most requested books are
+ * on the front desk; everything else is shelved in sorted order in
+ * the basement and fetched a trolley-load at a time.
+ */
+template <typename T, typename P, typename Codec = TrivialCodec<T>>
+class ExternalPriorityQueue {
+    static_assert(std::is_trivially_copyable<P>::value, "Priorities are stored raw on disk");
+
+private:
+    struct Entry {
+        P priority;
+        std::uint64_t seq; // Insertion order, breaks priority ties
+        T data;
+    };
+
+    static bool less(const Entry& a, const Entry& b) {
+        if (a.priority < b.priority) return true;
+        if (b.priority < a.priority) return false;
+        return a.seq < b.seq;
+    }
+
+    // For std::*_heap, which builds a max-heap
+    struct Greater {
+        bool operator()(const Entry& a, const Entry& b) const { return less(b, a); }
+    };
+
+    static const std::size_t IO_BUFFER_BYTES = 1 << 20;
+
+    // One sorted run on disk, read sequentially
+    struct Run {
+        std::string path;
+        std::ifstream in;
+        std::vector<char> buffer;
+        std::uint64_t remaining; // Entries not yet read into `head`
+        Entry head;              // Smallest entry not yet returned
+        bool exhausted;
+        unsigned level;          // Number of merges its entries went through
+
+        Run(std::string p, std::uint64_t count, unsigned lvl) : path(std::move(p)), buffer(IO_BUFFER_BYTES),
+                                                                remaining(count), exhausted(false), level(lvl) {
+            in.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+            in.open(path, std::ios::binary);
+            try {
+                if (!in) {
+                    throw std::runtime_error("ExternalPriorityQueue: cannot read run " + path);
+                }
+                advance();
+            } catch (...) {
+                // The destructor won't run for a half-built Run
+                in.close();
+                std::remove(path.c_str());
+                throw;
+            }
+        }
+
+        ~Run() {
+            in.close();
+            std::remove(path.c_str());
+        }
+
+        void advance() {
+            if (remaining == 0) {
+                exhausted = true;
+                return;
+            }
+            if (!in.read(reinterpret_cast<char*>(&head.priority), sizeof(P)) ||
+                !in.read(reinterpret_cast<char*>(&head.seq), sizeof(head.seq)) ||
+                !Codec::decode(in, head.data)) {
+                throw std::runtime_error("ExternalPriorityQueue: truncated run " + path);
+            }
+            remaining--;
+        }
+    };
+
+    /*
+     * Loser tree over the runs. Leaves are runs k..2k-1, internal
+     * nodes 1..k-1 hold the index of the run that LOST the match
+     * there, and tree[0] holds the overall winner.
+     */
+    class LoserTree {
+    private:
+        std::vector<std::size_t> tree;
+        const std::vector<std::unique_ptr<Run>>* runs;
+
+        // True if run a's head should come out before run b's
+        bool beats(std::size_t a, std::size_t b) const {
+            const Run& ra = *(*runs)[a];
+            const Run& rb = *(*runs)[b];
+            if (ra.exhausted) return false;
+            if (rb.exhausted) return true;
+            return less(ra.head, rb.head);
+        }
+
+    public:
+        LoserTree() : runs(nullptr) {}
+
+        // Complexity: O(k)
+        void build(const std::vector<std::unique_ptr<Run>>& r) {
+            runs = &r;
+            std::size_t k = r.size();
+            tree.assign(std::max<std::size_t>(k, 1), 0);
+            if (k <= 1) return;
+
+            std::vector<std::size_t> winners(2 * k);
+            for (std::size_t i = 0; i < k; i++) winners[k + i] = i;
+            for (std::size_t n = k - 1; n >= 1; n--) {
+                std::size_t a = winners[2 * n], b = winners[2 * n + 1];
+                bool a_wins = beats(a, b);
+                winners[n] = a_wins ? a : b;
+                tree[n] = a_wins ? b : a;
+            }
+            tree[0] = winners[1];
+        }
+
+        std::size_t winner() const {
+            return tree[0];
+        }
+
+        // Re-run the matches on the path of the winner after its run advanced
+        // Complexity: O(log k)
+        void replay() {
+            std::size_t k = runs->size();
+            std::size_t w = tree[0];
+            for (std::size_t n = (w + k) / 2; n >= 1; n /= 2) {
+                if (beats(tree[n], w)) std::swap(tree[n], w);
+            }
+            tree[0] = w;
+        }
+    };
+
+    std::string dir;
+    std::size_t memory_limit;
+    std::size_t max_fan_in;
+    std::vector<Entry> heap; // In-memory part, a heap under Greater
+    std::vector<std::unique_ptr<Run>> runs;
+    LoserTree tree;
+    std::uint64_t next_seq;
+    std::uint64_t next_run_id;
+    std::size_t _size;
+    std::uint64_t spilled_bytes;
+
+    std::string run_path() {
+        return dir + "/epq-" + std::to_string((long)getpid()) + "-" + std::to_string((std::uintptr_t)this) + "-" +
+               std::to_string(next_run_id++) + ".run";
+    }
+
+    // Write entries (already sorted) produced by `next` as a new run
+    template <typename Next>
+    void write_run(std::uint64_t count, unsigned level, Next next) {
+        std::string path = run_path();
+        std::vector<char> buffer(IO_BUFFER_BYTES);
+        std::ofstream out;
+        out.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+        out.open(path, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("ExternalPriorityQueue: cannot create run " + path);
+        }
+        for (std::uint64_t i = 0; i < count; i++) {
+            const Entry& e = next();
+            out.write(reinterpret_cast<const char*>(&e.priority), sizeof(P));
+            out.write(reinterpret_cast<const char*>(&e.seq), sizeof(e.seq));
+            Codec::encode(out, e.data);
+        }
+        spilled_bytes += (std::uint64_t)out.tellp();
+        out.close();
+        if (!out) {
+            std::remove(path.c_str());
+            throw std::runtime_error("ExternalPriorityQueue: write failed for run " + path);
+        }
+        runs.push_back(std::unique_ptr<Run>(new Run(path, count, level)));
+    }
+
+    // Sort the in-memory heap and move it to disk as one run
+    void spill() {
+        std::sort(heap.begin(), heap.end(), less);
+        std::size_t i = 0;
+        write_run(heap.size(), 0, [&]() -> const Entry& { return heap[i++]; });
+        heap.clear();
+
+        drop_exhausted_runs();
+        for (unsigned level = 0; runs_at(level) >= max_fan_in; level++) {
+            merge_level(level);
+        }
+        tree.build(runs);
+    }
+
+    std::size_t runs_at(unsigned level) const {
+        return (std::size_t)std::count_if(runs.begin(), runs.end(),
+                                          [level](const std::unique_ptr<Run>& r) { return r->level == level; });
+    }
+
+    // Merge the runs of one level into a single run of the next level
+    // with the loser tree; sequential I/O only
+    void merge_level(unsigned level) {
+        std::vector<std::unique_ptr<Run>> inputs;
+        std::vector<std::unique_ptr<Run>> others;
+        for (auto& r : runs) {
+            (r->level == level ? inputs : others).push_back(std::move(r));
+        }
+        runs.swap(others);
+        LoserTree merger;
+        merger.build(inputs);
+
+        std::uint64_t total = 0;
+        for (const auto& r : inputs) {
+            total += r->remaining + (r->exhausted ? 0 : 1);
+        }
+        Entry current;
+        write_run(total, level + 1, [&]() -> const Entry& {
+            Run& r = *inputs[merger.winner()];
+            current = std::move(r.head);
+            r.advance();
+            merger.replay();
+            return current;
+        });
+        // `inputs` go out of scope here, deleting their files
+    }
+
+    void drop_exhausted_runs() {
+        runs.erase(std::remove_if(runs.begin(), runs.end(),
+                                  [](const std::unique_ptr<Run>& r) { return r->exhausted; }),
+                   runs.end());
+    }
+
+    // True if the next entry comes from the runs rather than memory
+    bool min_on_disk() const {
+        if (runs.empty() || runs[tree.winner()]->exhausted) return false;
+        if (heap.empty()) return true;
+        return less(runs[tree.winner()]->head, heap.front());
+    }
+
+public:
+    /*
+     * `directory`     - where run files go (must exist, ideally local disk)
+     * `memory_limit`  - max entries held in RAM before spilling
+     * `max_fan_in`    - runs of one level merged at once
+     */
+    ExternalPriorityQueue(std::string directory, std::size_t memory_limit = 1 << 20, std::size_t max_fan_in = 64)
+        : dir(std::move(directory)), memory_limit(std::max<std::size_t>(memory_limit, 1)),
+          max_fan_in(std::max<std::size_t>(max_fan_in, 2)), next_seq(0), next_run_id(0), _size(0),
+          spilled_bytes(0) {}
+
+    ExternalPriorityQueue(const ExternalPriorityQueue&) = delete;
+    ExternalPriorityQueue& operator=(const ExternalPriorityQueue&) = delete;
+
+    // Add an item with the given priority (lower number = higher priority)
+    // Complexity: O(log M), plus a sequential spill every M inserts
+    void insert(T data, P priority) {
+        heap.push_back(Entry{priority, next_seq++, std::move(data)});
+        std::push_heap(heap.begin(), heap.end(), Greater());
+        _size++;
+        if (heap.size() >= memory_limit) {
+            spill();
+        }
+    }
+
+    // Remove and return the (priority, data) pair with the highest priority
+    // Complexity: O(log M + log k)
+    std::pair<P, T> extract_min() {
+        if (isEmpty()) {
+            throw std::runtime_error("PriorityQueue is empty");
+        }
+        _size--;
+        if (min_on_disk()) {
+            Run& r = *runs[tree.winner()];
+            std::pair<P, T> item(r.head.priority, std::move(r.head.data));
+            r.advance();
+            tree.replay();
+            return item;
+        }
+        std::pop_heap(heap.begin(), heap.end(), Greater());
+        std::pair<P, T> item(heap.back().priority, std::move(heap.back().data));
+        heap.pop_back();
+        return item;
+    }
+
+    // Return the highest-priority (priority, data) pair without removing it
+    // Complexity: O(1)
+    std::pair<P, T> peek_min() const {
+        if (isEmpty()) {
+            throw std::runtime_error("PriorityQueue is empty");
+        }
+        const Entry& e = min_on_disk() ? runs[tree.winner()]->head : heap.front();
+        return std::make_pair(e.priority, e.data);
+    }
+
+    bool isEmpty() const {
+        return _size == 0;
+    }
+
+    std::size_t size() const {
+        return _size;
+    }
+
+    // Number of run files currently open
+    std::size_t run_count() const {
+        return runs.size();
+    }
+
+    // Total bytes written to run files so far (spills + merges)
+    std::uint64_t bytes_spilled() const {
+        return spilled_bytes;
+    }
+};
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+
+/*
+ * Index layouts for the array-backed PriorityQueue.
+ *
+ * A layout only answers "where are the parent and children of the
+ * node in slot i?". PriorityQueue does the rest (sift up/down,
+ * growth), so the layout can change without touching heap logic.
+ * In every layout the right child sits right after the left one.
+ */
+
+/*
+ * The classic implicit binary heap: root at 0, children of i at
+ * 2i+1 and 2i+2. Compact and simple, but the two children of a node
+ * deep in a big heap are far away from it: once the heap is larger
+ * than the caches, every level of a sift-down is a cache miss, and
+ * below the first few levels a TLB miss too.
+ */
+struct BinaryHeapLayout {
+    static const bool has_holes = false;
+
+    static std::size_t root() { return 0; }
+    static bool is_hole(std::size_t) { return false; }
+    static std::size_t parent(std::size_t i) { return (i - 1) / 2; }
+    static std::size_t left(std::size_t i) { return 2 * i + 1; }
+};
+
+/*
+ * Page-aware "B-heap" layout (after Varnish's binheap).
+ *
+ * The array is cut into pages of PAGE_SLOTS slots, and each page
+ * holds a small subtree, so a sift-down walks ~log2(PAGE_SLOTS)
+ * levels inside one page - one TLB entry, a handful of cache lines -
+ * before it has to move to another page.
+ *
+ * Page 0 is a normal 1-based heap (slot 0 unused): root at 1,
+ * children of j at 2j and 2j+1. Every other page holds a PAIR of
+ * sibling subtrees rooted at slots 0 and 1, with children of j at
+ * 2j+2 and 2j+3; its last two slots are unused. Either way the two
+ * children of a node are adjacent, so comparing them is one cache
+ * line, and the children of a page's bottom row (PAGE_SLOTS / 2
+ * nodes) are the root pairs of the next PAGE_SLOTS / 2 pages, which
+ * are numbered breadth-first.
+ *
+ * A parent always sits at a lower index than its children, so the
+ * heap fills slots (and pages) strictly in order and only the last
+ * page is ever partly empty.
+ *
+ * Pick PAGE_SLOTS so that PAGE_SLOTS * sizeof(entry) is a VM page
+ * (vm_page_slots below) and page-align the array, or every logical
+ * page straddles two VM pages (see PagedPriorityQueue in
+ * PriorityQueue.h).
+ *
+ * Measure before switching (benchmarks/bheap_bench): the index math
+ * costs more and the tree gets a few levels deeper, so while the
+ * heap stays resident with plenty of TLB reach the binary layout is
+ * usually faster. The B-heap pays off when the heap is paged out or
+ * the TLB is the bottleneck.
+ */
+template <std::size_t PAGE_SLOTS>
+struct BHeapLayout {
+    static_assert(PAGE_SLOTS >= 4 && (PAGE_SLOTS & (PAGE_SLOTS - 1)) == 0,
+                  "PAGE_SLOTS must be a power of two >= 4");
+    static const bool has_holes = true;
+    static const std::size_t HALF = PAGE_SLOTS / 2; // Bottom-row nodes (and child pages) per page
+
+    static std::size_t root() { return 1; }
+
+    static bool is_hole(std::size_t i) {
+        std::size_t slot = i % PAGE_SLOTS;
+        return i < PAGE_SLOTS ? slot == 0 : slot >= PAGE_SLOTS - 2;
+    }
+
+    static std::size_t parent(std::size_t i) {
+        std::size_t page = i / PAGE_SLOTS, slot = i % PAGE_SLOTS;
+        if (page == 0) {
+            return slot / 2;
+        }
+        if (slot >= 2) {
+            return page * PAGE_SLOTS + (slot - 2) / 2;
+        }
+        // A page root: its parent is on the bottom row of the parent page
+        std::size_t parent_page = (page - 1) / HALF, k = (page - 1) % HALF;
+        std::size_t first_bottom = parent_page == 0 ? HALF : HALF - 2;
+        return parent_page * PAGE_SLOTS + first_bottom + k;
+    }
+
+    static std::size_t left(std::size_t i) {
+        std::size_t page = i / PAGE_SLOTS, slot = i % PAGE_SLOTS;
+        std::size_t first_bottom = page == 0 ? HALF : HALF - 2;
+        if (slot < first_bottom) {
+            return page == 0 ? 2 * slot : page * PAGE_SLOTS + 2 * slot + 2;
+        }
+        // Bottom row: children are the root pair of a new page
+        return (page * HALF + 1 + (slot - first_bottom)) * PAGE_SLOTS;
+    }
+};
+
+static const std::size_t VM_PAGE_SIZE = 4096;
+
+// Slots of `Entry` that exactly fill one VM page, for BHeapLayout
+template <typename Entry>
+constexpr std::size_t vm_page_slots() {
+    static_assert(VM_PAGE_SIZE % sizeof(Entry) == 0 && sizeof(Entry) <= VM_PAGE_SIZE / 4,
+                  "Entries must tile a VM page exactly: pad the entry to a power of two <= VM_PAGE_SIZE / 4");
+    return VM_PAGE_SIZE / sizeof(Entry);
+}
@@ -0,0 +1,109 @@
+#include "HugePageArena.h"
+#include <iostream>
+
+// POSIX / Linux headers
+#include <sys/mman.h>
+
+static std::size_t round_up(std::size_t v, std::size_t to) {
+    return (v + to - 1) / to * to;
+}
+
+HugePageArena::HugePageArena(std::size_t size, PageMode mode)
+    : region_size(round_up(size == 0 ? HUGE_PAGE_SIZE : size, HUGE_PAGE_SIZE)),
+      requested_mode(mode), active_mode(mode), cursor(nullptr), limit(nullptr),
+      used(0), reserved(0), destructors(nullptr) {}
+
+HugePageArena::~HugePageArena() {
+    reset();
+}
+
+const char* HugePageArena::mode_name(PageMode mode) {
+    switch (mode) {
+        case PageMode::Auto: return "auto";
+        case PageMode::HugeTLB: return "hugetlb";
+        case PageMode::Transparent: return "transparent";
+        case PageMode::Regular: return "regular";
+    }
+    return "unknown";
+}
+
+/*
+ * Maps a new region of at least `min_size` bytes, walking down the
+ * page sources until one works.
+ */
+bool HugePageArena::map_region(std::size_t min_size) {
+    std::size_t size = round_up(min_size > region_size ? min_size : region_size, HUGE_PAGE_SIZE);
+    void* base = MAP_FAILED;
+    PageMode got = PageMode::Regular;
+
+    if (requested_mode == PageMode::Auto || requested_mode == PageMode::HugeTLB) {
+#ifdef MAP_HUGETLB
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        got = PageMode::HugeTLB;
+#endif
+    }
+
+    if (base == MAP_FAILED && requested_mode != PageMode::Regular) {
+        // Over-map by one huge page so we can align the start to 2MB,
+        // which THP needs to back the range with huge pages
+        std::size_t padded = size + HUGE_PAGE_SIZE;
+        void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw != MAP_FAILED) {
+            std::uintptr_t start = round_up((std::uintptr_t)raw, HUGE_PAGE_SIZE);
+            std::size_t head = start - (std::uintptr_t)raw;
+            if (head > 0) munmap(raw, head);
+            if (padded - head > size) munmap((char*)start + size, padded - head - size);
+            base = (void*)start;
+#ifdef MADV_HUGEPAGE
+            got = madvise(base, size, MADV_HUGEPAGE) == 0 ? PageMode::Transparent : PageMode::Regular;
+#endif
+        }
+    }
+
+    if (base == MAP_FAILED) {
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        got = PageMode::Regular;
+    }
+    if (base == MAP_FAILED) {
+        return false;
+    }
+
+    if (requested_mode != PageMode::Auto && got != requested_mode && regions.empty()) {
+        std::cerr << "[Arena]: Huge pages unavailable, fell back to " << mode_name(got) << " pages" << std::endl;
+    }
+    active_mode = got;
+    regions.push_back({(char*)base, size});
+    cursor = (char*)base;
+    limit = cursor + size;
+    reserved += size;
+    return true;
+}
+
+void* HugePageArena::allocate(std::size_t size, std::size_t alignment) {
+    std::uintptr_t p = round_up((std::uintptr_t)cursor, alignment);
+    if (cursor == nullptr || p + size > (std::uintptr_t)limit) {
+        if (!map_region(size + alignment)) {
+            throw std::bad_alloc();
+        }
+        p = round_up((std::uintptr_t)cursor, alignment);
+    }
+    cursor = (char*)(p + size);
+    used += size;
+    return (void*)p;
+}
+
+void HugePageArena::reset() {
+    // Newest first, mirroring construction order
+    while (destructors) {
+        Destructor* d = destructors;
+        destructors = d->next;
+        d->destroy(d->object);
+    }
+    for (const Region& r : regions) {
+        munmap(r.base, r.size);
+    }
+    regions.clear();
+    cursor = limit = nullptr;
+    used = reserved = 0;
+    active_mode = requested_mode;
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource> // HugePageArena is a std::pmr::memory_resource
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * Bump-pointer arena backed by 2MB huge pages.
+ *
+ * With millions of Tasks and heap nodes spread over 4KB pages, the
+ * scheduler spends much of its time on TLB misses. Carving objects
+ * out of 2MB pages lets one TLB entry cover 512x more memory.
+ *
+ * Page sources, tried in order (PageMode::Auto):
+ * 1. HugeTLB     - mmap(MAP_HUGETLB); needs pages reserved in
+ *                  /proc/sys/vm/nr_hugepages
+ * 2. Transparent - 2MB-aligned anonymous mmap + madvise(MADV_HUGEPAGE)
+ * 3. Regular     - plain 4KB pages (always works)
+ *
+ * Memory is only released all at once (reset() or destruction).
+ * Objects made with create<T>() have their destructors run then, in
+ * reverse order. Use ArenaAllocator<T> to put std::vector heap arrays
+ * and strings in the arena, or pass the arena itself as a
+ * std::pmr::memory_resource (e.g. to PmrQueue or std::pmr::vector).
+ *
+ * Not thread-safe: use one arena per thread or guard it externally.
+ */
+class HugePageArena : public std::pmr::memory_resource {
+public:
+    enum class PageMode { Auto, HugeTLB, Transparent, Regular };
+
+    static const std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+    // Memory is reserved `region_size` bytes at a time (rounded up to 2MB)
+    explicit HugePageArena(std::size_t region_size = 64 * 1024 * 1024, PageMode mode = PageMode::Auto);
+    ~HugePageArena();
+
+    HugePageArena(const HugePageArena&) = delete;
+    HugePageArena& operator=(const HugePageArena&) = delete;
+
+    // Complexity: O(1) (amortized; a new region is mapped when full)
+    void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+    // Construct a T in the arena; its destructor runs on reset()
+    template <typename T, typename... Args>
+    T* create(Args&&... args) {
+        void* mem = allocate(sizeof(T), alignof(T));
+        T* obj = new (mem) T(std::forward<Args>(args)...);
+        if (!std::is_trivially_destructible<T>::value) {
+            void* rec = allocate(sizeof(Destructor), alignof(Destructor));
+            destructors = new (rec) Destructor{obj, [](void* p) { static_cast<T*>(p)->~T(); }, destructors};
+        }
+        return obj;
+    }
+
+    // Run pending destructors and unmap everything
+    void reset();
+
+    std::size_t bytes_used() const { return used; }
+    std::size_t bytes_reserved() const { return reserved; }
+
+    // Page source actually used by the most recent region
+    PageMode mode() const { return active_mode; }
+    static const char* mode_name(PageMode mode);
+
+private:
+    struct Region {
+        char* base;
+        std::size_t size;
+    };
+    struct Destructor {
+        void* object;
+        void (*destroy)(void*);
+        Destructor* next;
+    };
+
+    std::size_t region_size;
+    PageMode requested_mode;
+    PageMode active_mode;
+    std::vector<Region> regions;
+    char* cursor;
+    char* limit;
+    std::size_t used;
+    std::size_t reserved;
+    Destructor* destructors;
+
+    bool map_region(std::size_t min_size);
+
+    // std::pmr::memory_resource interface; deallocation is a no-op
+    void* do_allocate(std::size_t size, std::size_t alignment) override {
+        return allocate(size, alignment);
+    }
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+/*
+ * Standard allocator that carves memory out of a HugePageArena.
+ * deallocate() is a no-op; memory returns when the arena resets.
+ *
+ *   std::vector<Task*, ArenaAllocator<Task*>> heap(ArenaAllocator<Task*>(arena));
+ *   ArenaString title("Fix login", ArenaAllocator<char>(arena));
+ */
+template <typename T>
+class ArenaAllocator {
+public:
+    typedef T value_type;
+
+    explicit ArenaAllocator(HugePageArena& a) : arena(&a) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, std::size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+private:
+    template <typename U> friend class ArenaAllocator;
+    HugePageArena* arena;
+};
+
+typedef std::basic_string<char, std::char_traits<char>, ArenaAllocator<char>> ArenaString;
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
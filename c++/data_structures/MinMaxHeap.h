@@ -0,0 +1,216 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>          // For std::allocator, std::allocator_traits
+#include <memory_resource> // For std::pmr::polymorphic_allocator
+#include <optional>
+#include <stdexcept>       // For std::runtime_error
+#include <utility>
+#include <vector>
+
+/*
+ * Templated Min-Max Heap (a double-ended priority queue).
+ * Header-only.
+ *
+ * Like the binary heap in PriorityQueue, it lives in one array,
+ * but the levels alternate: nodes on even levels (0, 2, ...) are
+ * <= everything below them, nodes on odd levels are >= everything
+ * below them. So the minimum is the root and the maximum is one of
+ * its two children. Both ends can be peeked in O(1) and popped in
+ * O(log n) (Atkinson et al., 1986).
+ *
+ * Ordering is by (priority, insertion order): equal priorities come
+ * out of the min end FIFO, and the max end gives up the newest one
+ * first.
+ *
+ * Used as a bounded scheduler: insert_bounded() keeps at most
+ * `capacity` entries, shedding the least urgent (priority 5, newest)
+ * work first under memory pressure.
+ *
+ * Analogy: A hospital ward with a fixed number of beds. The most
+ * urgent patient is seen first, and when the ward is full the least
+ * urgent one is sent home.
+ */
+template <typename T, typename P, typename Alloc = std::allocator<T>>
+class MinMaxHeap {
+private:
+    struct Entry {
+        P priority;
+        std::uint64_t seq;
+        T data;
+    };
+    using EntryAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Entry>;
+
+    std::vector<Entry, EntryAlloc> heap;
+    std::uint64_t next_seq;
+
+    static bool less(const Entry& a, const Entry& b) {
+        if (a.priority < b.priority) return true;
+        if (b.priority < a.priority) return false;
+        return a.seq < b.seq;
+    }
+
+    static bool on_min_level(std::size_t i) {
+        int level = 0;
+        for (std::size_t n = i + 1; n > 1; n >>= 1) {
+            level++;
+        }
+        return level % 2 == 0;
+    }
+
+    bool below(std::size_t a, std::size_t b, bool min_side) const {
+        return min_side ? less(heap[a], heap[b]) : less(heap[b], heap[a]);
+    }
+
+    // Bubble i up through grandparents on its own kind of level
+    void bubble_up_grand(std::size_t i, bool min_side) {
+        while (i > 2) {
+            std::size_t gp = ((i - 1) / 2 - 1) / 2;
+            if (!below(i, gp, min_side)) break;
+            std::swap(heap[i], heap[gp]);
+            i = gp;
+        }
+    }
+
+    // Complexity: O(log n)
+    void bubble_up(std::size_t i) {
+        if (i == 0) return;
+        std::size_t parent = (i - 1) / 2;
+        bool min_side = on_min_level(i);
+        if (below(parent, i, min_side)) {
+            // Belongs on the other kind of level
+            std::swap(heap[i], heap[parent]);
+            bubble_up_grand(parent, !min_side);
+        } else {
+            bubble_up_grand(i, min_side);
+        }
+    }
+
+    // Complexity: O(log n)
+    void trickle_down(std::size_t i) {
+        bool min_side = on_min_level(i);
+        std::size_t n = heap.size();
+        while (2 * i + 1 < n) {
+            // Best of up to 2 children and 4 grandchildren
+            std::size_t m = 2 * i + 1;
+            std::size_t candidates[] = {2 * i + 2, 4 * i + 3, 4 * i + 4, 4 * i + 5, 4 * i + 6};
+            for (std::size_t c : candidates) {
+                if (c < n && below(c, m, min_side)) m = c;
+            }
+            if (!below(m, i, min_side)) break;
+            std::swap(heap[m], heap[i]);
+            if (m <= 2 * i + 2) break; // Was a child: it has no grandchildren to fix
+
+            std::size_t parent = (m - 1) / 2;
+            if (below(parent, m, min_side)) {
+                std::swap(heap[m], heap[parent]);
+            }
+            i = m;
+        }
+    }
+
+    std::size_t max_index() const {
+        if (heap.size() == 1) return 0;
+        if (heap.size() == 2) return 1;
+        return less(heap[1], heap[2]) ? 2 : 1;
+    }
+
+    std::pair<P, T> remove_at(std::size_t i) {
+        std::pair<P, T> item(std::move(heap[i].priority), std::move(heap[i].data));
+        if (i != heap.size() - 1) {
+            heap[i] = std::move(heap.back());
+        }
+        heap.pop_back();
+        if (i < heap.size()) {
+            trickle_down(i);
+        }
+        return item;
+    }
+
+public:
+    typedef Alloc allocator_type;
+
+    explicit MinMaxHeap(const Alloc& a = Alloc()) : heap(EntryAlloc(a)), next_seq(0) {}
+
+    // Add an item with the given priority (lower number = higher priority)
+    // Complexity: O(log n)
+    void insert(T data, P priority) {
+        heap.push_back(Entry{std::move(priority), next_seq++, std::move(data)});
+        bubble_up(heap.size() - 1);
+    }
+
+    /*
+     * Insert, keeping at most `capacity` entries. When full, the
+     * least urgent entry of (everything queued + the new one) is
+     * shed and returned so the caller can log it, requeue it to the
+     * DB, etc. Returns nothing if nothing was shed.
+     * Complexity: O(log n)
+     */
+    std::optional<std::pair<P, T>> insert_bounded(T data, P priority, std::size_t capacity) {
+        if (capacity == 0) {
+            return std::make_pair(std::move(priority), std::move(data));
+        }
+        if (heap.size() < capacity) {
+            insert(std::move(data), std::move(priority));
+            return std::nullopt;
+        }
+        // The newcomer has the newest seq, so it loses ties
+        if (!(priority < heap[max_index()].priority)) {
+            return std::make_pair(std::move(priority), std::move(data));
+        }
+        std::pair<P, T> shed = extract_max();
+        insert(std::move(data), std::move(priority));
+        return shed;
+    }
+
+    // Remove and return the most urgent (priority, data) pair
+    // Complexity: O(log n)
+    std::pair<P, T> extract_min() {
+        if (isEmpty()) {
+            throw std::runtime_error("MinMaxHeap is empty");
+        }
+        return remove_at(0);
+    }
+
+    // Remove and return the least urgent (priority, data) pair
+    // Complexity: O(log n)
+    std::pair<P, T> extract_max() {
+        if (isEmpty()) {
+            throw std::runtime_error("MinMaxHeap is empty");
+        }
+        return remove_at(max_index());
+    }
+
+    // Complexity: O(1)
+    std::pair<P, T> peek_min() const {
+        if (isEmpty()) {
+            throw std::runtime_error("MinMaxHeap is empty");
+        }
+        return std::make_pair(heap[0].priority, heap[0].data);
+    }
+
+    // Complexity: O(1)
+    std::pair<P, T> peek_max() const {
+        if (isEmpty()) {
+            throw std::runtime_error("MinMaxHeap is empty");
+        }
+        const Entry& e = heap[max_index()];
+        return std::make_pair(e.priority, e.data);
+    }
+
+    bool isEmpty() const {
+        return heap.empty();
+    }
+
+    int size() const {
+        return (int)heap.size();
+    }
+
+    allocator_type get_allocator() const {
+        return allocator_type(heap.get_allocator());
+    }
+};
+
+// MinMaxHeap whose storage comes from a std::pmr::memory_resource
+template <typename T, typename P>
+using PmrMinMaxHeap = MinMaxHeap<T, P, std::pmr::polymorphic_allocator<T>>;
@@ -1,4 +1,7 @@
 #pragma once
+#include <cstddef>  // For std::ptrdiff_t
+#include <iterator> // For std::forward_iterator_tag
+#include <utility>  // For std::move
 
 /*
  * This is a generic, templated Node class.
@@ -10,6 +13,47 @@ struct Node {
     T data;
     Node<T>* next;
 
-    // Constructor to initialize the node
-    Node(T val) : data(val), next(nullptr) {}
-};
\ No newline at end of file
+    // Constructor to initialize the node.
+    // Moves the value in, so move-only types (std::unique_ptr) work.
+    Node(T val) : data(std::move(val)), next(nullptr) {}
+};
+
+/*
+ * Read-only forward iterator over a chain of Nodes, shared by
+ * Queue and Stack. It satisfies std::forward_iterator, so the
+ * containers work with range-for, <algorithm>, std::reduce and
+ * (under C++20) std::ranges without copying anything out.
+ *
+ * Invalidated only when the node it points at is removed.
+ */
+template <typename T>
+class NodeIterator {
+private:
+    const Node<T>* node;
+
+public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const T*;
+    using reference = const T&;
+
+    NodeIterator() : node(nullptr) {}
+    explicit NodeIterator(const Node<T>* n) : node(n) {}
+
+    reference operator*() const { return node->data; }
+    pointer operator->() const { return &node->data; }
+
+    NodeIterator& operator++() {
+        node = node->next;
+        return *this;
+    }
+    NodeIterator operator++(int) {
+        NodeIterator old = *this;
+        node = node->next;
+        return old;
+    }
+
+    bool operator==(const NodeIterator& other) const { return node == other.node; }
+    bool operator!=(const NodeIterator& other) const { return node != other.node; }
+};
@@ -0,0 +1,352 @@
+#pragma once
+#include <algorithm> // For std::is_sorted
+#include <cstddef>
+#include <deque>
+#include <cstdint>
+#include <functional>
+#include <iterator> // For std::forward_iterator_tag
+#include <memory>
+#include <memory_resource> // For std::pmr::polymorphic_allocator
+#include <mutex>
+#include <queue>
+#include <stdexcept> // For std::runtime_error
+#include <utility>
+#include <vector>
+
+/*
+ * Persistent (immutable-node) Priority Queue, built as a leftist
+ * min-heap.
+ *
+ * Nodes are never modified after creation. insert() and
+ * extract_min() build a new root by copying only the O(log n) nodes
+ * on the right spine they touch; every other node is shared with the
+ * previous version via std::shared_ptr.
+ *
+ * That makes snapshot() O(1): it just copies the root pointer. A
+ * Snapshot is a consistent, immutable view that dashboards and admin
+ * tools can read from other threads while the executor keeps
+ * inserting and extracting; memory is shared between versions and
+ * freed once no version refers to it.
+ *
+ * Threading: one writer (the executor) and any number of snapshot
+ * readers. Only the root pointer is guarded by a mutex, and only
+ * for the length of a pointer copy.
+ *
+ * Equal priorities come out in insertion order (FIFO), matching the
+ * "ORDER BY priority, created_at" the scheduler is loaded with.
+ *
+ * Nodes (and their shared_ptr control blocks) are allocated from
+ * `Alloc` via std::allocate_shared. A snapshot keeps nodes alive
+ * past the queue, so the allocator's memory must outlive every
+ * Snapshot taken from it.
+ *
+ * Analogy: Git history. A new commit reuses every unchanged file
+ * from its parent, and old commits stay readable forever.
+ */
+template <typename T, typename P, typename Alloc = std::allocator<T>>
+class PersistentPriorityQueue {
+private:
+    struct Node {
+        std::pair<P, T> entry; // (priority, data)
+        std::uint64_t seq;     // Insertion order, breaks priority ties
+        int rank;          // Length of the right spine ("s-value")
+        std::shared_ptr<const Node> left;
+        std::shared_ptr<const Node> right;
+
+        Node(P p, std::uint64_t s, T d, std::shared_ptr<const Node> l, std::shared_ptr<const Node> r)
+            : entry(std::move(p), std::move(d)), seq(s), left(std::move(l)), right(std::move(r)) {
+            // Leftist property: the left child has the longer right spine
+            if (rank_of(left) < rank_of(right)) {
+                std::swap(left, right);
+            }
+            rank = rank_of(right) + 1;
+        }
+
+        // Unlink uniquely-owned descendants iteratively: the default
+        // recursive destruction can overflow the stack on long chains.
+        ~Node() {
+            std::vector<std::shared_ptr<const Node>> pending;
+            if (left && left.use_count() == 1) pending.push_back(std::move(left));
+            if (right && right.use_count() == 1) pending.push_back(std::move(right));
+            while (!pending.empty()) {
+                std::shared_ptr<const Node> n = std::move(pending.back());
+                pending.pop_back();
+                Node* m = const_cast<Node*>(n.get()); // Sole owner, about to be freed
+                if (m->left && m->left.use_count() == 1) pending.push_back(std::move(m->left));
+                if (m->right && m->right.use_count() == 1) pending.push_back(std::move(m->right));
+            }
+        }
+    };
+    using NodePtr = std::shared_ptr<const Node>;
+    using NodeAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+
+    static int rank_of(const NodePtr& n) {
+        return n ? n->rank : 0;
+    }
+
+    static bool less(const NodePtr& a, const NodePtr& b) {
+        if (a->entry.first < b->entry.first) return true;
+        if (b->entry.first < a->entry.first) return false;
+        return a->seq < b->seq;
+    }
+
+    NodePtr make_node(P priority, std::uint64_t seq, T data, NodePtr left, NodePtr right) const {
+        return std::allocate_shared<Node>(alloc, priority, seq, std::move(data), std::move(left), std::move(right));
+    }
+
+    // Merge two heaps, copying only the nodes on the merge path.
+    // Complexity: O(log n)
+    NodePtr merge(const NodePtr& a, const NodePtr& b) const {
+        if (!a) return b;
+        if (!b) return a;
+        if (less(b, a)) {
+            return merge(b, a);
+        }
+        return make_node(a->entry.first, a->seq, a->entry.second, a->left, merge(a->right, b));
+    }
+
+    NodeAlloc alloc;
+    NodePtr root;        // Written only by the owning thread
+    std::size_t _size;
+    std::uint64_t next_seq;
+    mutable std::mutex root_mutex; // Guards publishing/reading `root` across threads
+
+    void publish(NodePtr new_root, std::size_t new_size) {
+        std::lock_guard<std::mutex> lock(root_mutex);
+        root = std::move(new_root);
+        _size = new_size;
+    }
+
+public:
+    /*
+     * Read-only forward iterator over a Snapshot's (priority, data)
+     * entries in heap (pre-)order, NOT sorted order. It carries its
+     * own small stack of pending subtrees (O(log n) deep on the right
+     * spine, O(depth) in general), so copying one is not free.
+     */
+    class const_iterator {
+    private:
+        std::vector<const Node*> pending; // back() is the current node
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<P, T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() {}
+        explicit const_iterator(const Node* root) {
+            if (root) pending.push_back(root);
+        }
+
+        reference operator*() const { return pending.back()->entry; }
+        pointer operator->() const { return &pending.back()->entry; }
+
+        const_iterator& operator++() {
+            const Node* n = pending.back();
+            pending.pop_back();
+            if (n->right) pending.push_back(n->right.get());
+            if (n->left) pending.push_back(n->left.get());
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            if (pending.empty() || other.pending.empty()) return pending.empty() == other.pending.empty();
+            return pending.back() == other.pending.back();
+        }
+        bool operator!=(const const_iterator& other) const { return !(*this == other); }
+    };
+
+    /*
+     * An immutable view of the queue at the moment snapshot() was
+     * called. Cheap to copy; safe to read from any thread.
+     */
+    class Snapshot {
+    private:
+        NodePtr root;
+        std::size_t _size;
+
+    public:
+        Snapshot() : _size(0) {}
+        Snapshot(NodePtr r, std::size_t s) : root(std::move(r)), _size(s) {}
+
+        bool isEmpty() const {
+            return root == nullptr;
+        }
+
+        std::size_t size() const {
+            return _size;
+        }
+
+        // Highest-priority entry as (priority, data)
+        // Complexity: O(1)
+        std::pair<P, T> peek_min() const {
+            if (isEmpty()) {
+                throw std::runtime_error("Snapshot is empty");
+            }
+            return root->entry;
+        }
+
+        // The k highest-priority entries, in order.
+        // Only walks a frontier of candidates, never the whole heap.
+        // Complexity: O(k log k)
+        std::vector<std::pair<P, T>> top(std::size_t k) const {
+            std::vector<std::pair<P, T>> result;
+            auto worse = [](const Node* a, const Node* b) {
+                if (b->entry.first < a->entry.first) return true;
+                if (a->entry.first < b->entry.first) return false;
+                return a->seq > b->seq;
+            };
+            std::priority_queue<const Node*, std::vector<const Node*>, decltype(worse)> frontier(worse);
+            if (root) frontier.push(root.get());
+            while (!frontier.empty() && result.size() < k) {
+                const Node* n = frontier.top();
+                frontier.pop();
+                result.push_back(n->entry);
+                if (n->left) frontier.push(n->left.get());
+                if (n->right) frontier.push(n->right.get());
+            }
+            return result;
+        }
+
+        // Visit every (priority, data) entry in no particular order.
+        // Complexity: O(n)
+        void for_each(const std::function<void(const P&, const T&)>& visit) const {
+            for (const std::pair<P, T>& entry : *this) {
+                visit(entry.first, entry.second);
+            }
+        }
+
+        // Unordered iteration over every entry; see const_iterator
+        typedef typename PersistentPriorityQueue::const_iterator iterator;
+        const_iterator begin() const { return const_iterator(root.get()); }
+        const_iterator end() const { return const_iterator(); }
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+    };
+
+    typedef Alloc allocator_type;
+
+    explicit PersistentPriorityQueue(const Alloc& a = Alloc()) : alloc(a), _size(0), next_seq(0) {}
+
+    // Add an item with the given priority (lower number = higher priority)
+    // Complexity: O(log n)
+    void insert(T data, P priority) {
+        NodePtr single = make_node(priority, next_seq++, std::move(data), nullptr, nullptr);
+        publish(merge(root, single), _size + 1);
+    }
+
+    /*
+     * Insert many items at once, e.g. a whole DB result set.
+     * Equal priorities keep their order in `items` (FIFO).
+     *
+     * If `items` is already sorted by priority (like getPendingTasks'
+     * ORDER BY priority, created_at), it becomes a chain of left
+     * children: every node has rank 1, so the leftist and heap
+     * properties hold with no comparisons at all. Otherwise the
+     * singletons are melded pairwise, round by round (a leftist
+     * heapify). Either way no per-item O(log n) insert is paid.
+     * Complexity: O(n) to build, plus O(log n) to meld into the queue
+     */
+    void bulk_load(std::vector<std::pair<P, T>> items) {
+        if (items.empty()) {
+            return;
+        }
+        std::uint64_t base_seq = next_seq;
+        next_seq += items.size();
+
+        bool sorted = std::is_sorted(items.begin(), items.end(),
+                                     [](const std::pair<P, T>& a, const std::pair<P, T>& b) { return a.first < b.first; });
+        NodePtr built;
+        if (sorted) {
+            for (std::size_t i = items.size(); i-- > 0;) {
+                built = make_node(std::move(items[i].first), base_seq + i, std::move(items[i].second), std::move(built), nullptr);
+            }
+        } else {
+            std::deque<NodePtr> heaps;
+            for (std::size_t i = 0; i < items.size(); i++) {
+                heaps.push_back(make_node(std::move(items[i].first), base_seq + i, std::move(items[i].second), nullptr, nullptr));
+            }
+            while (heaps.size() > 1) {
+                NodePtr a = std::move(heaps.front());
+                heaps.pop_front();
+                NodePtr b = std::move(heaps.front());
+                heaps.pop_front();
+                heaps.push_back(merge(a, b));
+            }
+            built = std::move(heaps.front());
+        }
+        publish(merge(root, built), _size + items.size());
+    }
+
+    // Remove and return the (priority, data) pair with the highest priority
+    // Complexity: O(log n)
+    std::pair<P, T> extract_min() {
+        if (isEmpty()) {
+            throw std::runtime_error("PriorityQueue is empty");
+        }
+        NodePtr old_root = root; // Keeps the node alive until we're done
+        std::pair<P, T> item = old_root->entry;
+        publish(merge(old_root->left, old_root->right), _size - 1);
+        return item;
+    }
+
+    // Return the highest-priority (priority, data) pair without removing it
+    // Complexity: O(1)
+    std::pair<P, T> peek_min() const {
+        if (isEmpty()) {
+            throw std::runtime_error("PriorityQueue is empty");
+        }
+        return root->entry;
+    }
+
+    // Move every entry of `other` into this queue; `other` is left
+    // empty. Leftist heaps are meldable: only the two right spines
+    // are walked, so melding two backlogs of a million tasks touches
+    // ~40 nodes. Nodes keep the allocator they were created with.
+    // Ties between the two queues are broken by their own insertion
+    // counters, so FIFO order is only exact within each side.
+    // Complexity: O(log n + log m)
+    void meld(PersistentPriorityQueue& other) {
+        if (&other == this || other.isEmpty()) {
+            return;
+        }
+        NodePtr other_root = other.root;
+        std::size_t other_size = other._size;
+        other.publish(nullptr, 0);
+        if (other.next_seq > next_seq) {
+            next_seq = other.next_seq;
+        }
+        publish(merge(root, other_root), _size + other_size);
+    }
+
+    // Consistent, immutable view of the current state. May be called
+    // from any thread while the owner keeps mutating the queue.
+    // Complexity: O(1)
+    Snapshot snapshot() const {
+        std::lock_guard<std::mutex> lock(root_mutex);
+        return Snapshot(root, _size);
+    }
+
+    bool isEmpty() const {
+        return root == nullptr;
+    }
+
+    int size() const {
+        return (int)_size;
+    }
+
+    allocator_type get_allocator() const {
+        return allocator_type(alloc);
+    }
+};
+
+// Scheduler whose nodes come from a std::pmr::memory_resource
+template <typename T, typename P>
+using PmrPersistentPriorityQueue = PersistentPriorityQueue<T, P, std::pmr::polymorphic_allocator<T>>;
@@ -0,0 +1,313 @@
+#pragma once
+#include <algorithm>       // For std::is_sorted
+#include <cstddef>
+#include <iterator>        // For std::forward_iterator_tag
+#include <memory>          // For std::allocator, std::allocator_traits
+#include <memory_resource> // For std::pmr::polymorphic_allocator
+#include <new>             // For std::align_val_t
+#include <stdexcept>       // For std::runtime_error
+#include <type_traits>     // For std::conditional
+#include <utility>
+#include <vector>
+#include "HeapLayout.h"
+
+/*
+ * Templated Priority Queue implemented as an array-backed binary
+ * Min-Heap. Header-only.
+ *
+ * Every parent's priority is <= its children's, so the minimum
+ * (highest priority, lowest number) is always at the root.
+ * Where a node's children live is up to `Layout` (HeapLayout.h):
+ * by default children of i are at 2i+1 and 2i+2; BHeapLayout packs
+ * subtrees into VM pages for heaps much larger than the caches.
+ *
+ * Entries are stored as (priority, data) pairs, like the Python
+ * version. Storage comes from `Alloc`, as in Queue and Stack.
+ * Layouts with holes keep a default-constructed entry in each hole.
+ *
+ * Iteration walks the underlying array: every entry exactly once,
+ * in HEAP order (not sorted). That is enough for reports, counts
+ * and reductions without extracting anything.
+ *
+ * Analogy: An emergency room. Patients are not treated FIFO, but
+ * based on the severity of their condition (priority).
+ */
+template <typename T, typename P, typename Alloc = std::allocator<T>, typename Layout = BinaryHeapLayout>
+class PriorityQueue {
+public:
+    typedef std::pair<P, T> value_type;
+
+private:
+    using EntryAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<value_type>;
+    using Storage = std::vector<value_type, EntryAlloc>;
+
+    Storage heap;       // Slot i of the layout is heap[i]
+    std::size_t _size;  // Entries, not counting holes
+
+    // Move a new item up until its parent is no larger
+    // Complexity: O(log n)
+    void perc_up(std::size_t i) {
+        while (i != Layout::root()) {
+            std::size_t parent = Layout::parent(i);
+            if (!(heap[i].first < heap[parent].first)) break;
+            std::swap(heap[i], heap[parent]);
+            i = parent;
+        }
+    }
+
+    // Move the item at i down below any smaller child
+    // Complexity: O(log n)
+    void perc_down(std::size_t i) {
+        std::size_t n = heap.size();
+        while (true) {
+            std::size_t mc = Layout::left(i);
+            if (mc >= n) break;
+            if (mc + 1 < n && heap[mc + 1].first < heap[mc].first) {
+                mc++; // Siblings are always adjacent
+            }
+            if (!(heap[mc].first < heap[i].first)) break;
+            std::swap(heap[i], heap[mc]);
+            i = mc;
+        }
+    }
+
+    // Floyd's bottom-up heapify of the whole array
+    // Complexity: O(n)
+    void heapify() {
+        std::size_t start = Layout::has_holes ? heap.size() : heap.size() / 2;
+        for (std::size_t i = start; i-- > 0;) {
+            if (!Layout::is_hole(i)) perc_down(i);
+        }
+    }
+
+    // Put an entry in the next free slot (no sifting); returns its slot
+    std::size_t append(value_type entry) {
+        while (Layout::is_hole(heap.size())) {
+            heap.emplace_back();
+        }
+        heap.push_back(std::move(entry));
+        _size++;
+        return heap.size() - 1;
+    }
+
+    // Take the entry out of the last used slot
+    value_type remove_last() {
+        value_type entry = std::move(heap.back());
+        heap.pop_back();
+        while (!heap.empty() && Layout::is_hole(heap.size() - 1)) {
+            heap.pop_back();
+        }
+        _size--;
+        return entry;
+    }
+
+    // Forward iterator over the array that steps over layout holes
+    class SlotIterator {
+    private:
+        const std::pair<P, T>* slot;
+        const std::pair<P, T>* end;
+        std::size_t index;
+
+        void skip_holes() {
+            while (slot != end && Layout::is_hole(index)) {
+                slot++;
+                index++;
+            }
+        }
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::pair<P, T>;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        SlotIterator() : slot(nullptr), end(nullptr), index(0) {}
+        SlotIterator(const std::pair<P, T>* s, const std::pair<P, T>* e, std::size_t i) : slot(s), end(e), index(i) {
+            skip_holes();
+        }
+
+        reference operator*() const { return *slot; }
+        pointer operator->() const { return slot; }
+
+        SlotIterator& operator++() {
+            slot++;
+            index++;
+            skip_holes();
+            return *this;
+        }
+        SlotIterator operator++(int) {
+            SlotIterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const SlotIterator& other) const { return slot == other.slot; }
+        bool operator!=(const SlotIterator& other) const { return slot != other.slot; }
+    };
+
+public:
+    typedef Alloc allocator_type;
+    typedef typename std::conditional<Layout::has_holes, SlotIterator,
+                                      typename Storage::const_iterator>::type const_iterator;
+    typedef const_iterator iterator; // Mutating in place would break the heap
+
+    explicit PriorityQueue(const Alloc& a = Alloc()) : heap(EntryAlloc(a)), _size(0) {}
+
+    // Add an item with the given priority (lower number = higher priority)
+    // Complexity: O(log n)
+    void insert(T data, P priority) {
+        perc_up(append(value_type(std::move(priority), std::move(data))));
+    }
+
+    // Remove and return the (priority, data) pair with the highest priority
+    // Complexity: O(log n)
+    std::pair<P, T> extract_min() {
+        if (isEmpty()) {
+            throw std::runtime_error("PriorityQueue is empty");
+        }
+        value_type min_val = std::move(heap[Layout::root()]);
+        value_type last = remove_last();
+        if (!isEmpty()) {
+            heap[Layout::root()] = std::move(last);
+            perc_down(Layout::root());
+        }
+        return min_val;
+    }
+
+    // Return the highest-priority (priority, data) pair without removing it
+    // Complexity: O(1)
+    const value_type& peek_min() const {
+        if (isEmpty()) {
+            throw std::runtime_error("PriorityQueue is empty");
+        }
+        return heap[Layout::root()];
+    }
+
+    // Move every entry of `other` into this queue; `other` is left
+    // empty. A binary heap is not meldable, so this either inserts
+    // the smaller side one by one or re-heapifies the concatenation,
+    // whichever is cheaper. The arrays can only be swapped when both
+    // queues share an allocator; otherwise `other` is always the side
+    // moved over.
+    // Complexity: O(min(m log(n+m), n+m))
+    void meld(PriorityQueue& other) {
+        if (&other == this || other.isEmpty()) {
+            return;
+        }
+        if (_size < other._size && get_allocator() == other.get_allocator()) {
+            heap.swap(other.heap); // Always fold the smaller side in
+            std::swap(_size, other._size);
+        }
+        std::size_t n = _size, m = other._size;
+        std::vector<value_type> incoming;
+        incoming.reserve(m);
+        for (std::size_t i = 0; i < other.heap.size(); i++) {
+            if (!Layout::is_hole(i)) incoming.push_back(std::move(other.heap[i]));
+        }
+        other.heap.clear();
+        other._size = 0;
+
+        std::size_t log_nm = 1;
+        while ((std::size_t(1) << log_nm) < n + m) log_nm++;
+        if (m * log_nm < n + m) {
+            for (value_type& entry : incoming) {
+                perc_up(append(std::move(entry)));
+            }
+        } else {
+            for (value_type& entry : incoming) {
+                append(std::move(entry));
+            }
+            heapify();
+        }
+    }
+
+    /*
+     * Insert many (priority, data) pairs at once, e.g. a whole DB
+     * result set. Every layout puts parents at lower indices than
+     * their children, so a sorted array is already a valid min-heap:
+     * sorted input (ORDER BY priority) into an empty queue is just
+     * moved in; anything else gets Floyd's bottom-up heapify.
+     * Complexity: O(n + m)
+     */
+    void bulk_load(std::vector<value_type> items) {
+        if (items.empty()) {
+            return;
+        }
+        bool sorted = std::is_sorted(items.begin(), items.end(),
+                                     [](const value_type& a, const value_type& b) { return a.first < b.first; });
+        bool was_empty = isEmpty();
+        heap.reserve(heap.size() + items.size() + items.size() / 4);
+        for (value_type& entry : items) {
+            append(std::move(entry));
+        }
+        if (!(was_empty && sorted)) {
+            heapify();
+        }
+    }
+
+    // Unordered (heap-order) iteration over every entry
+    // Complexity: O(1) per step
+    const_iterator begin() const { return make_iterator(0); }
+    const_iterator end() const { return make_iterator(heap.size()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    bool isEmpty() const {
+        return _size == 0;
+    }
+
+    int size() const {
+        return (int)_size;
+    }
+
+    allocator_type get_allocator() const {
+        return allocator_type(heap.get_allocator());
+    }
+
+private:
+    template <typename L = Layout>
+    typename std::enable_if<L::has_holes, const_iterator>::type make_iterator(std::size_t i) const {
+        return SlotIterator(heap.data() + i, heap.data() + heap.size(), i);
+    }
+    template <typename L = Layout>
+    typename std::enable_if<!L::has_holes, const_iterator>::type make_iterator(std::size_t i) const {
+        return heap.cbegin() + i;
+    }
+};
+
+// PriorityQueue whose storage comes from a std::pmr::memory_resource
+template <typename T, typename P>
+using PmrPriorityQueue = PriorityQueue<T, P, std::pmr::polymorphic_allocator<T>>;
+
+// std::allocator, but every block starts on a VM page boundary
+template <typename T>
+struct PageAlignedAllocator {
+    typedef T value_type;
+
+    PageAlignedAllocator() = default;
+    template <typename U>
+    PageAlignedAllocator(const PageAlignedAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(VM_PAGE_SIZE)));
+    }
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(VM_PAGE_SIZE));
+    }
+
+    template <typename U>
+    bool operator==(const PageAlignedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const PageAlignedAllocator<U>&) const { return false; }
+};
+
+/*
+ * PriorityQueue in the page-aware B-heap layout: the array is page
+ * aligned and each layout page is exactly one VM page, so a subtree
+ * never straddles two. sizeof(std::pair<P, T>) must divide the page
+ * (a power of two); pad T if it doesn't, e.g. a 24-byte entry to 32.
+ */
+template <typename T, typename P>
+using PagedPriorityQueue =
+    PriorityQueue<T, P, PageAlignedAllocator<T>, BHeapLayout<vm_page_slots<std::pair<P, T>>()>>;
@@ -1,7 +1,9 @@
 #pragma once
 #include "Node.h"
 #include <iostream>
-#include <stdexcept> // For std::runtime_error
+#include <memory>          // For std::allocator, std::allocator_traits
+#include <memory_resource> // For std::pmr::polymorphic_allocator
+#include <stdexcept>       // For std::runtime_error
 
 /*
  * Templated Queue (FIFO) implementation.
@@ -10,16 +12,49 @@
  *
  * NOTE: This REPLACES the C++ example from the previous
  * response, as this templated version is far more useful.
+ *
+ * Allocator-aware: nodes come from `Alloc` (rebound to Node<T>),
+ * so a queue can live in a pool, a monotonic per-cycle buffer or a
+ * HugePageArena without changing any queue code:
+ *
+ *   std::pmr::unsynchronized_pool_resource pool;
+ *   PmrQueue<Task*> q(&pool);
  */
-template <typename T>
+template <typename T, typename Alloc = std::allocator<T>>
 class Queue {
 private:
+    using NodeAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node<T>>;
+    using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+    NodeAlloc alloc;
     Node<T>* head; // Front of the line
     Node<T>* tail; // Back of the line
     int _size;
 
+    Node<T>* create_node(T data) {
+        Node<T>* node = NodeTraits::allocate(alloc, 1);
+        try {
+            NodeTraits::construct(alloc, node, std::move(data));
+        } catch (...) {
+            NodeTraits::deallocate(alloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void destroy_node(Node<T>* node) {
+        NodeTraits::destroy(alloc, node);
+        NodeTraits::deallocate(alloc, node, 1);
+    }
+
 public:
-    Queue() : head(nullptr), tail(nullptr), _size(0) {}
+    typedef Alloc allocator_type;
+
+    explicit Queue(const Alloc& a = Alloc()) : alloc(a), head(nullptr), tail(nullptr), _size(0) {}
+
+    // Nodes are owned by exactly one queue
+    Queue(const Queue&) = delete;
+    Queue& operator=(const Queue&) = delete;
 
     // Destructor: Cleans up all nodes
     ~Queue() {
@@ -31,7 +66,7 @@ public:
     // Add an item to the back (tail) of the queue
     // Complexity: O(1)
     void enqueue(T data) {
-        Node<T>* newNode = new Node<T>(data);
+        Node<T>* newNode = create_node(std::move(data));
         if (isEmpty()) {
             head = newNode;
             tail = newNode;
@@ -50,14 +85,14 @@ public:
         }
 
         Node<T>* temp = head;
-        T data = head->data;
+        T data = std::move(head->data);
         head = head->next;
 
         if (head == nullptr) {
             tail = nullptr; // Queue is now empty
         }
 
-        delete temp; // Free the memory for the node
+        destroy_node(temp); // Free the memory for the node
         _size--;
 
         return data;
@@ -70,4 +105,47 @@ public:
     int size() const {
         return _size;
     }
-};
\ No newline at end of file
+
+    // Move every item of `other` to the back of this queue, keeping
+    // their order. `other` is left empty.
+    // Complexity: O(1) when both queues share an allocator,
+    // otherwise O(m) since nodes must be re-allocated
+    void splice(Queue& other) {
+        if (&other == this || other.isEmpty()) {
+            return;
+        }
+        if (!(alloc == other.alloc)) {
+            while (!other.isEmpty()) {
+                enqueue(other.dequeue());
+            }
+            return;
+        }
+        if (isEmpty()) {
+            head = other.head;
+        } else {
+            tail->next = other.head;
+        }
+        tail = other.tail;
+        _size += other._size;
+        other.head = other.tail = nullptr;
+        other._size = 0;
+    }
+
+    // Read-only iteration from front to back, without popping anything.
+    // Complexity: O(1) per step
+    typedef NodeIterator<T> const_iterator;
+    typedef NodeIterator<T> iterator; // Elements are never mutable in place
+
+    const_iterator begin() const { return const_iterator(head); }
+    const_iterator end() const { return const_iterator(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    allocator_type get_allocator() const {
+        return allocator_type(alloc);
+    }
+};
+
+// Queue whose nodes come from a std::pmr::memory_resource
+template <typename T>
+using PmrQueue = Queue<T, std::pmr::polymorphic_allocator<T>>;
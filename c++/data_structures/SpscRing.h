@@ -0,0 +1,214 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>          // For std::allocator, std::allocator_traits
+#include <memory_resource> // For std::pmr::polymorphic_allocator
+#include <new>             // For placement construction of slots
+#include <stdexcept>       // For std::runtime_error
+#include <utility>
+#include <vector>
+
+/*
+ * Bounded single-producer, single-consumer ring buffer. Header-only.
+ *
+ * The cheapest channel between two dedicated threads: exactly one
+ * thread may push and exactly one (other) thread may pop. Every
+ * operation is wait-free - a fixed number of steps, no locks, no
+ * CAS loops - and touches the other side's cache line as rarely as
+ * possible:
+ *
+ * - `tail` (written by the producer) and `head` (written by the
+ *   consumer) live on separate cache lines, so they don't bounce
+ *   between cores on every operation (false sharing).
+ * - Each side keeps a private cached copy of the other side's index
+ *   and only re-reads the shared one when the cache says the ring
+ *   looks full (producer) or empty (consumer).
+ * - The capacity is a power of two, so a slot is `index & mask`
+ *   rather than a division. Indices run freely and never wrap
+ *   in practice (64-bit).
+ * - push_batch/pop_batch publish many items with one release-store.
+ *
+ * Analogy: A conveyor belt between two workstations. The person
+ * loading it only looks up to check for space when the belt seemed
+ * full last time, and vice versa.
+ */
+template <typename T, typename Alloc = std::allocator<T>>
+class SpscRing {
+public:
+    static constexpr std::size_t CACHE_LINE = 64;
+
+private:
+    using Traits = std::allocator_traits<Alloc>;
+
+    // Consumer-owned line
+    alignas(CACHE_LINE) std::atomic<std::size_t> head;
+    std::size_t cached_tail; // Consumer's last view of tail
+
+    // Producer-owned line
+    alignas(CACHE_LINE) std::atomic<std::size_t> tail;
+    std::size_t cached_head; // Producer's last view of head
+
+    // Read-only after construction
+    alignas(CACHE_LINE) Alloc alloc;
+    T* slots;
+    std::size_t mask;
+
+    static std::size_t round_up_pow2(std::size_t n) {
+        std::size_t cap = 1;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+    // Free slots as the producer sees them (may re-read head)
+    std::size_t free_slots(std::size_t t, std::size_t wanted) {
+        std::size_t free_now = capacity() - (t - cached_head);
+        if (free_now < wanted) {
+            cached_head = head.load(std::memory_order_acquire);
+            free_now = capacity() - (t - cached_head);
+        }
+        return free_now;
+    }
+
+    // Ready items as the consumer sees them (may re-read tail)
+    std::size_t ready_slots(std::size_t h, std::size_t wanted) {
+        std::size_t ready = cached_tail - h;
+        if (ready < wanted) {
+            cached_tail = tail.load(std::memory_order_acquire);
+            ready = cached_tail - h;
+        }
+        return ready;
+    }
+
+public:
+    // `capacity` is rounded up to a power of two
+    explicit SpscRing(std::size_t capacity, const Alloc& a = Alloc())
+        : head(0), cached_tail(0), tail(0), cached_head(0), alloc(a), slots(nullptr), mask(0) {
+        if (capacity == 0) {
+            throw std::runtime_error("SpscRing capacity must be positive");
+        }
+        std::size_t cap = round_up_pow2(capacity);
+        slots = Traits::allocate(alloc, cap);
+        mask = cap - 1;
+    }
+
+    ~SpscRing() {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        for (; h != t; h++) {
+            Traits::destroy(alloc, slots + (h & mask));
+        }
+        Traits::deallocate(alloc, slots, capacity());
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer: construct an item in place. False if the ring is full.
+    // Complexity: O(1), wait-free
+    template <typename... Args>
+    bool try_emplace(Args&&... args) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        if (free_slots(t, 1) == 0) {
+            return false;
+        }
+        Traits::construct(alloc, slots + (t & mask), std::forward<Args>(args)...);
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push(const T& item) { return try_emplace(item); }
+    bool try_push(T&& item) { return try_emplace(std::move(item)); }
+
+    /*
+     * Producer: move up to `count` items from `items` into the ring
+     * and publish them all at once. Returns how many were taken (the
+     * rest are left untouched).
+     * Complexity: O(count), wait-free
+     */
+    std::size_t push_batch(T* items, std::size_t count) {
+        std::size_t t = tail.load(std::memory_order_relaxed);
+        std::size_t n = free_slots(t, count);
+        if (n > count) n = count;
+        for (std::size_t i = 0; i < n; i++) {
+            Traits::construct(alloc, slots + ((t + i) & mask), std::move(items[i]));
+        }
+        if (n > 0) {
+            tail.store(t + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // Consumer: take the oldest item. False if the ring is empty.
+    // Complexity: O(1), wait-free
+    bool try_pop(T& out) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        if (ready_slots(h, 1) == 0) {
+            return false;
+        }
+        T* slot = slots + (h & mask);
+        out = std::move(*slot);
+        Traits::destroy(alloc, slot);
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*
+     * Consumer: move up to `max_items` items onto the end of `out` and
+     * hand their slots back to the producer at once. Returns how many
+     * were taken.
+     * Complexity: O(max_items), wait-free
+     */
+    std::size_t pop_batch(std::vector<T>& out, std::size_t max_items) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        std::size_t n = ready_slots(h, max_items);
+        if (n > max_items) n = max_items;
+        for (std::size_t i = 0; i < n; i++) {
+            T* slot = slots + ((h + i) & mask);
+            out.push_back(std::move(*slot));
+            Traits::destroy(alloc, slot);
+        }
+        if (n > 0) {
+            head.store(h + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // Same, into a caller-provided array (no vector growth on the hot path)
+    std::size_t pop_batch(T* out, std::size_t max_items) {
+        std::size_t h = head.load(std::memory_order_relaxed);
+        std::size_t n = ready_slots(h, max_items);
+        if (n > max_items) n = max_items;
+        for (std::size_t i = 0; i < n; i++) {
+            T* slot = slots + ((h + i) & mask);
+            out[i] = std::move(*slot);
+            Traits::destroy(alloc, slot);
+        }
+        if (n > 0) {
+            head.store(h + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // Approximate when called while the other side is running
+    std::size_t size() const {
+        std::size_t t = tail.load(std::memory_order_acquire);
+        std::size_t h = head.load(std::memory_order_acquire);
+        return t - h;
+    }
+
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+    std::size_t capacity() const {
+        return mask + 1;
+    }
+
+    Alloc get_allocator() const {
+        return alloc;
+    }
+};
+
+// SpscRing whose slot array comes from a std::pmr::memory_resource
+template <typename T>
+using PmrSpscRing = SpscRing<T, std::pmr::polymorphic_allocator<T>>;
@@ -0,0 +1,156 @@
+#pragma once
+#include "Node.h"
+#include <iostream>
+#include <memory>          // For std::allocator, std::allocator_traits
+#include <memory_resource> // For std::pmr::polymorphic_allocator
+#include <stdexcept>       // For std::runtime_error
+#include <vector>
+
+/*
+ * Templated Stack (LIFO) implementation.
+ * It is header-only because it's a template.
+ * Analogy: A stack of plates.
+ *
+ * Allocator-aware in the same way as Queue: nodes come from
+ * `Alloc` rebound to Node<T>. PmrStack<T> takes a memory_resource.
+ */
+template <typename T, typename Alloc = std::allocator<T>>
+class Stack {
+private:
+    using NodeAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<Node<T>>;
+    using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+    NodeAlloc alloc;
+    Node<T>* top;
+    Node<T>* bottom; // Last node in the chain; lets splice() run in O(1)
+    int _size;
+
+    Node<T>* create_node(T data) {
+        Node<T>* node = NodeTraits::allocate(alloc, 1);
+        try {
+            NodeTraits::construct(alloc, node, std::move(data));
+        } catch (...) {
+            NodeTraits::deallocate(alloc, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    void destroy_node(Node<T>* node) {
+        NodeTraits::destroy(alloc, node);
+        NodeTraits::deallocate(alloc, node, 1);
+    }
+
+public:
+    typedef Alloc allocator_type;
+
+    explicit Stack(const Alloc& a = Alloc()) : alloc(a), top(nullptr), bottom(nullptr), _size(0) {}
+
+    // Nodes are owned by exactly one stack
+    Stack(const Stack&) = delete;
+    Stack& operator=(const Stack&) = delete;
+
+    // Destructor: Essential to prevent memory leaks!
+    // It walks the list and deletes every node.
+    ~Stack() {
+        while (!isEmpty()) {
+            pop(); // Pop will delete the node
+        }
+    }
+
+    // Push an item onto the top of the stack
+    // Complexity: O(1)
+    void push(T data) {
+        Node<T>* newNode = create_node(std::move(data));
+        newNode->next = top;
+        if (top == nullptr) {
+            bottom = newNode;
+        }
+        top = newNode;
+        _size++;
+    }
+
+    // Remove and return the top item
+    // Complexity: O(1)
+    T pop() {
+        if (isEmpty()) {
+            throw std::runtime_error("Stack is empty");
+        }
+        
+        Node<T>* temp = top;
+        T data = std::move(top->data);
+        top = top->next;
+        if (top == nullptr) {
+            bottom = nullptr; // Stack is now empty
+        }
+        
+        destroy_node(temp); // Free the memory for the node
+        _size--;
+        
+        return data;
+    }
+
+    // Return top item without removing
+    // Complexity: O(1)
+    T peek() const {
+        if (isEmpty()) {
+            throw std::runtime_error("Stack is empty");
+        }
+        return top->data;
+    }
+
+    bool isEmpty() const {
+        return top == nullptr;
+    }
+
+    int size() const {
+        return _size;
+    }
+
+    // Move every item of `other` onto this stack, keeping their order
+    // (other's top becomes the new top). `other` is left empty.
+    // Complexity: O(1) when both stacks share an allocator,
+    // otherwise O(m) since nodes must be re-allocated
+    void splice(Stack& other) {
+        if (&other == this || other.isEmpty()) {
+            return;
+        }
+        if (!(alloc == other.alloc)) {
+            std::vector<T> items;
+            items.reserve(other._size);
+            while (!other.isEmpty()) {
+                items.push_back(other.pop());
+            }
+            for (auto it = items.rbegin(); it != items.rend(); ++it) {
+                push(std::move(*it));
+            }
+            return;
+        }
+        other.bottom->next = top;
+        if (top == nullptr) {
+            bottom = other.bottom;
+        }
+        top = other.top;
+        _size += other._size;
+        other.top = other.bottom = nullptr;
+        other._size = 0;
+    }
+
+    // Read-only iteration from top to bottom, without popping anything.
+    // Complexity: O(1) per step
+    typedef NodeIterator<T> const_iterator;
+    typedef NodeIterator<T> iterator; // Elements are never mutable in place
+
+    const_iterator begin() const { return const_iterator(top); }
+    const_iterator end() const { return const_iterator(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    allocator_type get_allocator() const {
+        return allocator_type(alloc);
+    }
+};
+
+// Stack whose nodes come from a std::pmr::memory_resource
+template <typename T>
+using PmrStack = Stack<T, std::pmr::polymorphic_allocator<T>>;
@@ -1,6 +1,8 @@
 #include "DatabaseConnector.h"
+#include "../cache/TaskCache.h"
 #include <stdexcept>
 #include <iostream>
+#include <algorithm>
 
 // Include specific MySQL Connector headers
 #include <cppconn/prepared_statement.h>
@@ -10,7 +12,7 @@
 
 
 DatabaseConnector::DatabaseConnector(std::string h, std::string u, std::string p, std::string d)
-    : host(h), user(u), pass(p), db(d), driver(nullptr), con(nullptr) {
+    : host(h), user(u), pass(p), db(d), driver(nullptr), con(nullptr), cache(nullptr), next_replica(0) {
     
     try {
         // Get the MySQL driver instance
@@ -37,6 +39,10 @@ void DatabaseConnector::connect() {
 }
 
 void DatabaseConnector::disconnect() {
+    for (ReadReplica& replica : replicas) {
+        delete replica.con;
+    }
+    replicas.clear();
     if (con) {
         delete con;
         con = nullptr;
@@ -44,6 +50,120 @@ void DatabaseConnector::disconnect() {
     }
 }
 
+void DatabaseConnector::setCache(TaskCache* c) {
+    cache = c;
+}
+
+// --- Read/write splitting ---
+
+bool DatabaseConnector::addReadReplica(const std::string& replica_host, int max_lag_seconds) {
+    ReadReplica replica;
+    replica.host = replica_host;
+    replica.max_lag_seconds = max_lag_seconds;
+    try {
+        replica.con = driver->connect(replica_host, user, pass);
+        replica.con->setSchema(db);
+    } catch (sql::SQLException &e) {
+        std::cerr << "Read replica " << replica_host << " unreachable: " << e.what() << std::endl;
+        if (replica.con) delete replica.con;
+        return false;
+    }
+    checkReplicaLag(replica);
+    std::cout << "Read replica " << replica_host << " added (lag ";
+    if (replica.lag_seconds < 0) {
+        std::cout << "unknown, not used until replication runs)" << std::endl;
+    } else {
+        std::cout << replica.lag_seconds << "s)" << std::endl;
+    }
+    replicas.push_back(replica);
+    return true;
+}
+
+void DatabaseConnector::checkReplicaLag(ReadReplica& replica) {
+    // MySQL 8.0.22+ understands SHOW REPLICA STATUS; older MySQL and
+    // MariaDB < 10.5 only the SLAVE spelling. The lag column is
+    // Seconds_Behind_Source on new MySQL, Seconds_Behind_Master elsewhere.
+    const char* queries[] = {"SHOW REPLICA STATUS", "SHOW SLAVE STATUS"};
+    const char* columns[] = {"Seconds_Behind_Source", "Seconds_Behind_Master"};
+
+    replica.checked_at = std::chrono::steady_clock::now();
+    replica.lag_seconds = -1;
+    for (const char* query : queries) {
+        sql::Statement* stmt = nullptr;
+        sql::ResultSet* res = nullptr;
+        try {
+            stmt = replica.con->createStatement();
+            res = stmt->executeQuery(query);
+            if (res->next()) { // No row: not a replica at all
+                for (const char* column : columns) {
+                    try {
+                        if (!res->isNull(column)) replica.lag_seconds = res->getInt(column);
+                        break;
+                    } catch (sql::SQLException &) {
+                        // Column has the other name on this server
+                    }
+                }
+            }
+            delete res;
+            delete stmt;
+            return;
+        } catch (sql::SQLException &) {
+            if (res) delete res;
+            if (stmt) delete stmt;
+        }
+    }
+    std::cerr << "Could not read replication status of " << replica.host << std::endl;
+}
+
+sql::Connection* DatabaseConnector::readConnection() {
+    auto now = std::chrono::steady_clock::now();
+    for (std::size_t tried = 0; tried < replicas.size(); tried++) {
+        ReadReplica& replica = replicas[next_replica];
+        next_replica = (next_replica + 1) % replicas.size();
+
+        if (now - replica.checked_at >= REPLICA_CHECK_INTERVAL) {
+            checkReplicaLag(replica);
+        }
+        if (replica.lag_seconds < 0 || replica.lag_seconds > replica.max_lag_seconds) {
+            continue;
+        }
+        // It may not have applied our own last write yet
+        if (now - last_write < std::chrono::seconds(replica.lag_seconds + 1)) {
+            continue;
+        }
+        return replica.con;
+    }
+    return con;
+}
+
+bool DatabaseConnector::replicaFailed(sql::Connection* c) {
+    for (ReadReplica& replica : replicas) {
+        if (replica.con == c) {
+            std::cerr << "Read replica " << replica.host << " failed, reading from the primary" << std::endl;
+            replica.lag_seconds = -1;
+            replica.checked_at = std::chrono::steady_clock::now();
+            return true;
+        }
+    }
+    return false;
+}
+
+void DatabaseConnector::noteWrite() {
+    last_write = std::chrono::steady_clock::now();
+}
+
+// Maps the current row of a `SELECT * FROM Tasks` result to a new Task
+Task* DatabaseConnector::taskFromRow(sql::ResultSet* res) {
+    return new Task(
+        res->getString("title"),
+        res->getString("description"),
+        res->getInt("priority"),
+        res->getString("status"),
+        res->getInt("task_id"),
+        res->getInt("assignee_id")
+    );
+}
+
 // --- CRUD Operations ---
 
 Task* DatabaseConnector::createTask(Task* task) {
@@ -66,6 +186,7 @@ Task* DatabaseConnector::createTask(Task* task) {
         }
         
         pstmt->execute();
+        noteWrite();
         delete pstmt;
 
         // Get the last inserted ID to update the task object
@@ -76,6 +197,7 @@ Task* DatabaseConnector::createTask(Task* task) {
         }
         
         std::cout << "DB: Created Task ID " << task->task_id << std::endl;
+        if (cache) cache->onTaskCreated(*task);
         
         delete res;
         delete stmt;
@@ -90,26 +212,58 @@ Task* DatabaseConnector::createTask(Task* task) {
     }
 }
 
+Task* DatabaseConnector::getTaskById(int task_id) {
+    sql::Connection* rc = readConnection(); // Replica when one is caught up
+    Task* task = nullptr;
+    sql::PreparedStatement* pstmt = nullptr;
+    sql::ResultSet* res = nullptr;
+
+    try {
+        const char* sql = "SELECT task_id, assignee_id, title, description, status, priority, "
+                          "UNIX_TIMESTAMP(created_at) AS created_ts FROM Tasks WHERE task_id = ?";
+        pstmt = rc->prepareStatement(sql);
+        pstmt->setInt(1, task_id);
+        res = pstmt->executeQuery();
+
+        if (res->next()) {
+            task = taskFromRow(res);
+            task->created_at = res->getInt64("created_ts");
+            if (cache && rc == con) cache->upsert(*task); // Replica rows may be stale
+        }
+
+        delete res;
+        delete pstmt;
+
+    } catch (sql::SQLException &e) {
+        std::cerr << "Failed to get task " << task_id << ": " << e.what() << std::endl;
+        if (res) delete res;
+        if (pstmt) delete pstmt;
+        delete task;
+        task = nullptr;
+        if (replicaFailed(rc)) {
+            return getTaskById(task_id);
+        }
+    }
+    return task;
+}
+
 std::vector<Task*> DatabaseConnector::getPendingTasks() {
+    sql::Connection* rc = readConnection(); // Replica when one is caught up
     std::vector<Task*> tasks;
     sql::Statement* stmt = nullptr;
     sql::ResultSet* res = nullptr;
     
     try {
         const char* sql = "SELECT * FROM Tasks WHERE status = 'pending' ORDER BY priority ASC, created_at ASC";
-        stmt = con->createStatement();
+        stmt = rc->createStatement();
         res = stmt->executeQuery(sql);
         
         // Map rows to Task objects
         while (res->next()) {
-            tasks.push_back(new Task(
-                res->getString("title"),
-                res->getString("description"),
-                res->getInt("priority"),
-                res->getString("status"),
-                res->getInt("task_id"),
-                res->getInt("assignee_id")
-            ));
+            tasks.push_back(taskFromRow(res));
+        }
+        if (cache && rc == con) { // Replica rows may be older than the cache
+            for (Task* t : tasks) cache->upsert(*t); // Warm the cache with what we read
         }
         
         delete res;
@@ -119,10 +273,350 @@ std::vector<Task*> DatabaseConnector::getPendingTasks() {
         std::cerr << "Failed to get tasks: " << e.what() << std::endl;
         if (res) delete res;
         if (stmt) delete stmt;
+        if (replicaFailed(rc)) {
+            for (Task* t : tasks) delete t;
+            return getPendingTasks();
+        }
+    }
+    return tasks;
+}
+
+/*
+ * Only the next `k` pending tasks. With the (status, priority,
+ * created_at) index, MySQL walks the index in order and stops after
+ * k rows instead of sorting the whole backlog.
+ */
+std::vector<Task*> DatabaseConnector::getTopPendingTasks(int k) {
+    sql::Connection* rc = readConnection(); // Replica when one is caught up
+    std::vector<Task*> tasks;
+    sql::PreparedStatement* pstmt = nullptr;
+    sql::ResultSet* res = nullptr;
+
+    try {
+        const char* sql = "SELECT * FROM Tasks WHERE status = 'pending' "
+                          "ORDER BY priority ASC, created_at ASC LIMIT ?";
+        pstmt = rc->prepareStatement(sql);
+        pstmt->setInt(1, k);
+        res = pstmt->executeQuery();
+
+        tasks.reserve(k > 0 ? k : 0);
+        while (res->next()) {
+            tasks.push_back(taskFromRow(res));
+        }
+        if (cache && rc == con) { // Replica rows may be older than the cache
+            for (Task* t : tasks) cache->upsert(*t);
+        }
+
+        delete res;
+        delete pstmt;
+
+    } catch (sql::SQLException &e) {
+        std::cerr << "Failed to get top " << k << " pending tasks: " << e.what() << std::endl;
+        if (res) delete res;
+        if (pstmt) delete pstmt;
+        if (replicaFailed(rc)) {
+            for (Task* t : tasks) delete t;
+            return getTopPendingTasks(k);
+        }
+    }
+    return tasks;
+}
+
+/*
+ * Keyset cursor over the pending order. Each page picks up strictly
+ * after the last (priority, created_at, task_id) seen, so it is a
+ * range scan on idx_status_priority_created (InnoDB appends the
+ * primary key to it) no matter how deep into the backlog we are,
+ * unlike LIMIT/OFFSET.
+ */
+std::vector<Task*> DatabaseConnector::getPendingTasksAfter(const PendingCursor& after, int limit) {
+    sql::Connection* rc = readConnection(); // Replica when one is caught up
+    std::vector<Task*> tasks;
+    sql::PreparedStatement* pstmt = nullptr;
+    sql::ResultSet* res = nullptr;
+
+    try {
+        const char* sql = "SELECT task_id, assignee_id, title, description, status, priority, "
+                          "UNIX_TIMESTAMP(created_at) AS created_ts "
+                          "FROM Tasks WHERE status = 'pending' AND "
+                          "(priority > ? OR (priority = ? AND "
+                          "(created_at > FROM_UNIXTIME(?) OR (created_at = FROM_UNIXTIME(?) AND task_id > ?)))) "
+                          "ORDER BY priority ASC, created_at ASC, task_id ASC LIMIT ?";
+        pstmt = rc->prepareStatement(sql);
+        pstmt->setInt(1, after.priority);
+        pstmt->setInt(2, after.priority);
+        pstmt->setInt64(3, after.created_at);
+        pstmt->setInt64(4, after.created_at);
+        pstmt->setInt(5, after.task_id);
+        pstmt->setInt(6, limit);
+        res = pstmt->executeQuery();
+
+        tasks.reserve(limit > 0 ? limit : 0);
+        while (res->next()) {
+            Task* t = taskFromRow(res);
+            t->created_at = res->getInt64("created_ts");
+            tasks.push_back(t);
+        }
+        if (cache && rc == con) { // Replica rows may be older than the cache
+            for (Task* t : tasks) cache->upsert(*t);
+        }
+
+        delete res;
+        delete pstmt;
+
+    } catch (sql::SQLException &e) {
+        std::cerr << "Failed to get pending tasks after (" << after.priority << ", " << after.created_at
+                  << ", " << after.task_id << "): " << e.what() << std::endl;
+        if (res) delete res;
+        if (pstmt) delete pstmt;
+        if (replicaFailed(rc)) {
+            for (Task* t : tasks) delete t;
+            return getPendingTasksAfter(after, limit);
+        }
     }
     return tasks;
 }
 
+std::vector<Task*> DatabaseConnector::getTasksByAssignee(int assignee_id) {
+    sql::Connection* rc = readConnection(); // Replica when one is caught up
+    std::vector<Task*> tasks;
+    sql::PreparedStatement* pstmt = nullptr;
+    sql::ResultSet* res = nullptr;
+
+    try {
+        const char* sql = "SELECT * FROM Tasks WHERE assignee_id = ? ORDER BY task_id ASC";
+        pstmt = rc->prepareStatement(sql);
+        pstmt->setInt(1, assignee_id);
+        res = pstmt->executeQuery();
+
+        while (res->next()) {
+            tasks.push_back(taskFromRow(res));
+        }
+        if (cache && rc == con) { // Replica rows may be older than the cache
+            for (Task* t : tasks) cache->upsert(*t);
+        }
+
+        delete res;
+        delete pstmt;
+
+    } catch (sql::SQLException &e) {
+        std::cerr << "Failed to get tasks for assignee " << assignee_id << ": " << e.what() << std::endl;
+        if (res) delete res;
+        if (pstmt) delete pstmt;
+        if (replicaFailed(rc)) {
+            for (Task* t : tasks) delete t;
+            return getTasksByAssignee(assignee_id);
+        }
+    }
+    return tasks;
+}
+
+bool DatabaseConnector::streamTasks(int batch_size, const std::function<void(const std::vector<Task>&)>& on_batch) {
+    sql::Connection* rc = readConnection(); // Replica when one is caught up
+    sql::PreparedStatement* pstmt = nullptr;
+    sql::ResultSet* res = nullptr;
+    std::vector<Task> batch;
+    int last_id = 0;
+
+    try {
+        // Keyset pagination: each page starts after the last id seen,
+        // so every page is an index range scan on the primary key
+        const char* sql = "SELECT task_id, assignee_id, title, description, status, priority, "
+                          "UNIX_TIMESTAMP(created_at) AS created_ts "
+                          "FROM Tasks WHERE task_id > ? ORDER BY task_id ASC LIMIT ?";
+        pstmt = rc->prepareStatement(sql);
+
+        while (true) {
+            pstmt->setInt(1, last_id);
+            pstmt->setInt(2, batch_size);
+            res = pstmt->executeQuery();
+
+            batch.clear();
+            while (res->next()) {
+                Task* t = taskFromRow(res);
+                t->created_at = res->getInt64("created_ts");
+                batch.push_back(*t);
+                delete t;
+            }
+            delete res;
+            res = nullptr;
+
+            if (batch.empty()) break;
+            last_id = batch.back().task_id;
+            on_batch(batch);
+            if ((int)batch.size() < batch_size) break;
+        }
+
+        delete pstmt;
+        return true;
+
+    } catch (sql::SQLException &e) {
+        std::cerr << "Failed to stream tasks after id " << last_id << ": " << e.what() << std::endl;
+        if (res) delete res;
+        if (pstmt) delete pstmt;
+        // Batches were already handed out, so don't restart on the
+        // primary; the next call will use it
+        replicaFailed(rc);
+        return false;
+    }
+}
+
+std::vector<TaskCountRow> DatabaseConnector::getTaskCounts() {
+    sql::Connection* rc = readConnection(); // Replica when one is caught up
+    std::vector<TaskCountRow> rows;
+    sql::Statement* stmt = nullptr;
+    sql::ResultSet* res = nullptr;
+
+    try {
+        const char* sql = "SELECT status, priority, IFNULL(assignee_id, 0) AS assignee_id, COUNT(*) AS n "
+                          "FROM Tasks GROUP BY status, priority, assignee_id";
+        stmt = rc->createStatement();
+        res = stmt->executeQuery(sql);
+
+        while (res->next()) {
+            rows.push_back(TaskCountRow{
+                res->getString("status"),
+                res->getInt("priority"),
+                res->getInt("assignee_id"),
+                res->getInt64("n")
+            });
+        }
+
+        delete res;
+        delete stmt;
+
+    } catch (sql::SQLException &e) {
+        std::cerr << "Failed to count tasks: " << e.what() << std::endl;
+        if (res) delete res;
+        if (stmt) delete stmt;
+        if (replicaFailed(rc)) {
+            return getTaskCounts();
+        }
+    }
+    return rows;
+}
+
+// --- Task history ---
+
+bool DatabaseConnector::insertTaskHistory(const std::vector<TaskHistoryRow>& rows) {
+    const std::size_t ROWS_PER_STATEMENT = 256;
+    sql::PreparedStatement* pstmt = nullptr;
+
+    if (rows.empty()) return true;
+    try {
+        con->setAutoCommit(false);
+        for (std::size_t start = 0; start < rows.size(); start += ROWS_PER_STATEMENT) {
+            std::size_t n = std::min(ROWS_PER_STATEMENT, rows.size() - start);
+            // One multi-row INSERT per chunk instead of a round trip per row
+            std::string sql = "INSERT INTO TaskHistory (task_id, changed_at_us, keyframe, fields, status, priority) VALUES ";
+            for (std::size_t i = 0; i < n; i++) {
+                sql += (i == 0) ? "(?, ?, ?, ?, ?, ?)" : ", (?, ?, ?, ?, ?, ?)";
+            }
+            pstmt = con->prepareStatement(sql);
+            int col = 1;
+            for (std::size_t i = start; i < start + n; i++) {
+                const TaskHistoryRow& row = rows[i];
+                pstmt->setInt(col++, row.task_id);
+                pstmt->setInt64(col++, row.changed_at_us);
+                pstmt->setInt(col++, row.keyframe ? 1 : 0);
+                pstmt->setInt(col++, row.fields);
+                if (row.fields & TaskHistoryRow::STATUS) {
+                    pstmt->setString(col++, row.status);
+                } else {
+                    pstmt->setNull(col++, 0);
+                }
+                if (row.fields & TaskHistoryRow::PRIORITY) {
+                    pstmt->setInt(col++, row.priority);
+                } else {
+                    pstmt->setNull(col++, 0);
+                }
+            }
+            pstmt->executeUpdate();
+            delete pstmt;
+            pstmt = nullptr;
+        }
+        con->commit();
+        con->setAutoCommit(true);
+        noteWrite();
+        return true;
+
+    } catch (sql::SQLException &e) {
+        std::cerr << "Failed to write " << rows.size() << " task history rows. Rolling back. " << e.what() << std::endl;
+        if (pstmt) delete pstmt;
+        try {
+            con->rollback();
+            con->setAutoCommit(true);
+        } catch (sql::SQLException &rb_e) {
+            std::cerr << "Rollback failed: " << rb_e.what() << std::endl;
+        }
+        return false;
+    }
+}
+
+std::vector<TaskHistoryRow> DatabaseConnector::getTaskHistoryAt(int task_id, std::int64_t at_us, int max_rows) {
+    sql::Connection* rc = readConnection(); // Replica when one is caught up
+    std::vector<TaskHistoryRow> rows;
+    sql::PreparedStatement* pstmt = nullptr;
+    sql::ResultSet* res = nullptr;
+
+    try {
+        // 1. The nearest keyframe (idx_history_keyframes, one probe)
+        const char* sql_keyframe = "SELECT history_id FROM TaskHistory "
+                                   "WHERE task_id = ? AND keyframe = 1 AND changed_at_us <= ? "
+                                   "ORDER BY changed_at_us DESC LIMIT 1";
+        pstmt = rc->prepareStatement(sql_keyframe);
+        pstmt->setInt(1, task_id);
+        pstmt->setInt64(2, at_us);
+        res = pstmt->executeQuery();
+        if (!res->next()) {
+            delete res;
+            delete pstmt;
+            return rows;
+        }
+        std::int64_t keyframe_id = res->getInt64("history_id");
+        delete res;
+        res = nullptr;
+        delete pstmt;
+        pstmt = nullptr;
+
+        // 2. It and the deltas after it (idx_history_task range scan).
+        // The LIMIT bounds the scan to one keyframe interval; filtering
+        // on changed_at_us in SQL instead would keep scanning through
+        // the task's whole later history looking for more matches.
+        const char* sql_deltas = "SELECT changed_at_us, keyframe, fields, status, priority FROM TaskHistory "
+                                 "WHERE task_id = ? AND history_id >= ? "
+                                 "ORDER BY history_id ASC LIMIT ?";
+        pstmt = rc->prepareStatement(sql_deltas);
+        pstmt->setInt(1, task_id);
+        pstmt->setInt64(2, keyframe_id);
+        pstmt->setInt(3, max_rows);
+        res = pstmt->executeQuery();
+        while (res->next()) {
+            if (res->getInt64("changed_at_us") > at_us) break; // Rows are in time order
+            TaskHistoryRow row;
+            row.task_id = task_id;
+            row.changed_at_us = res->getInt64("changed_at_us");
+            row.keyframe = res->getInt("keyframe") != 0;
+            row.fields = res->getInt("fields");
+            if (row.fields & TaskHistoryRow::STATUS) row.status = res->getString("status");
+            if (row.fields & TaskHistoryRow::PRIORITY) row.priority = res->getInt("priority");
+            rows.push_back(row);
+        }
+
+        delete res;
+        delete pstmt;
+
+    } catch (sql::SQLException &e) {
+        std::cerr << "Failed to read history of task " << task_id << ": " << e.what() << std::endl;
+        if (res) delete res;
+        if (pstmt) delete pstmt;
+        if (replicaFailed(rc)) {
+            return getTaskHistoryAt(task_id, at_us, max_rows);
+        }
+    }
+    return rows;
+}
+
 /*
  * Demonstrates an UPDATE query inside a Transaction.
  * Returns a pair: (success_bool, old_status_string)
@@ -160,10 +654,12 @@ std::pair<bool, std::string> DatabaseConnector::updateTaskStatus(int task_id, st
 
         // 3. Commit the transaction
         con->commit();
+        noteWrite();
         con->setAutoCommit(true); // Reset autocommit
         
         std::cout << "DB: Successfully updated Task " << task_id << " from '" 
                   << old_status << "' to '" << new_status << "'" << std::endl;
+        if (cache) cache->onStatusChanged(task_id, old_status, new_status);
 
         delete res;
         delete pstmt_select;
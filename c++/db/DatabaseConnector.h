@@ -1,5 +1,10 @@
 #pragma once
+#include <chrono>
+#include <cstdint>
 #include <string>
+#include <functional>
+#include <utility>
+#include <vector>
 // MySQL Connector C++ headers
 #include "mysql_driver.h"
 #include "mysql_connection.h"
@@ -8,9 +13,69 @@
 #include <cppconn/resultset.h>
 #include <cppconn/exception.h>
 #include "../models/Task.h"
+#include "../metrics/TaskCounters.h" // For TaskCountRow
 
+class TaskCache;
+
+// Position in the pending-task order (priority, created_at, task_id).
+// The default cursor sorts before every task.
+struct PendingCursor {
+    int priority = 0;
+    std::int64_t created_at = 0; // Unix seconds
+    int task_id = 0;
+};
+
+// One row of the TaskHistory table. Delta rows only carry the
+// fields flagged in `fields` (TaskHistoryRow::STATUS / PRIORITY).
+struct TaskHistoryRow {
+    static const int STATUS = 1;
+    static const int PRIORITY = 2;
+
+    int task_id = 0;
+    std::int64_t changed_at_us = 0; // Unix microseconds
+    bool keyframe = false;          // Carries every field
+    int fields = 0;
+    std::string status;
+    int priority = 0;
+};
+
+/*
+ * Read/write splitting: with read replicas added (addReadReplica),
+ * the plain read queries (getTaskById, getPendingTasks, ...) go to a
+ * replica, round-robin, and every write stays on the primary `con`.
+ *
+ * A replica is only used while it is caught up:
+ * - Its lag (Seconds_Behind_Source from SHOW REPLICA STATUS, or
+ *   Seconds_Behind_Master on older servers / MariaDB) is re-checked
+ *   at most every REPLICA_CHECK_INTERVAL and must be <= the
+ *   configured maximum. Stopped replication (NULL lag) disqualifies it.
+ * - Reads shortly after a write through this connector go to the
+ *   primary until the replica had time to apply it (lag + 1s), so a
+ *   caller always sees its own writes.
+ * - A replica that errors is skipped until its next lag check, and
+ *   the read is retried on the primary.
+ * - Rows read from a replica are not written into the TaskCache,
+ *   since they may be older than what the cache already holds.
+ *
+ * Only attach replicas to connections whose readers can tolerate a
+ * little staleness; the scheduler's own refill connection must not
+ * see tasks as pending after they were started.
+ *
+ * Local test: run a second MySQL/MariaDB on port 3307 as a replica
+ * of the first (CHANGE REPLICATION SOURCE TO ... / CHANGE MASTER TO
+ * ..., then START REPLICA) and add "tcp://127.0.0.1:3307". Stopping
+ * replication on it (STOP REPLICA) sends reads back to the primary.
+ */
 class DatabaseConnector {
 private:
+    struct ReadReplica {
+        std::string host;
+        sql::Connection* con = nullptr;
+        int max_lag_seconds = 0;
+        int lag_seconds = -1; // -1 = unknown, replication stopped or failed
+        std::chrono::steady_clock::time_point checked_at;
+    };
+
     sql::mysql::MySQL_Driver* driver;
     sql::Connection* con;
     
@@ -19,16 +84,65 @@ private:
     std::string pass;
     std::string db;
 
+    TaskCache* cache; // Optional, not owned. Kept in sync on writes.
+
+    std::vector<ReadReplica> replicas;
+    std::size_t next_replica;
+    std::chrono::steady_clock::time_point last_write;
+
+    Task* taskFromRow(sql::ResultSet* res);
+
+    // Where the next read-only query should run: a caught-up replica or `con`
+    sql::Connection* readConnection();
+    // Refreshes replica.lag_seconds
+    void checkReplicaLag(ReadReplica& replica);
+    // A read on `c` failed. Returns true if it was a replica (which is
+    // now skipped) and the read should be retried.
+    bool replicaFailed(sql::Connection* c);
+    void noteWrite();
+
 public:
     DatabaseConnector(std::string host, std::string user, std::string pass, std::string db);
     ~DatabaseConnector();
 
     void connect();
-    void disconnect();
+    void disconnect(); // Also closes the replica connections
+
+    static constexpr std::chrono::seconds REPLICA_CHECK_INTERVAL{1};
+
+    // Route read-only queries to `replicaHost` too (same user, password
+    // and schema; e.g. "tcp://127.0.0.1:3307") while its replication
+    // lag is at most `maxLagSeconds`. Returns false if it can't be reached.
+    bool addReadReplica(const std::string& replicaHost, int maxLagSeconds = 2);
+
+    // Every successful createTask/updateTaskStatus is mirrored into `c`
+    void setCache(TaskCache* c);
 
     // CRUD Operations
     Task* createTask(Task* task);
     Task* getTaskById(int taskId);
-    bool updateTaskStatus(int taskId, std::string newStatus);
-    std.vector<Task*> getPendingTasks(); // Uses std::vector (allowed)
+    std::pair<bool, std::string> updateTaskStatus(int taskId, std::string newStatus); // (success, old_status)
+    std::vector<Task*> getPendingTasks(); // Uses std::vector (allowed)
+    std::vector<Task*> getTopPendingTasks(int k); // Same order, first k only
+    // Next `limit` pending tasks strictly after `after`, in the same order
+    // (keyset pagination). Tasks carry created_at.
+    std::vector<Task*> getPendingTasksAfter(const PendingCursor& after, int limit);
+    std::vector<Task*> getTasksByAssignee(int assigneeId);
+
+    // Every task in task_id order, `batchSize` rows per callback, paging
+    // by task_id so the whole table is never held in memory.
+    // Tasks carry created_at. Returns false if a query failed.
+    bool streamTasks(int batchSize, const std::function<void(const std::vector<Task>&)>& onBatch);
+
+    // GROUP BY status, priority, assignee_id (for counter reconciliation)
+    std::vector<TaskCountRow> getTaskCounts();
+
+    // Task history (see TaskHistory). Inserts all rows in one
+    // transaction, a few hundred per statement. Returns false on error.
+    bool insertTaskHistory(const std::vector<TaskHistoryRow>& rows);
+    // The latest keyframe of `taskId` at or before `atUs`, followed by
+    // every delta after it up to `atUs`, oldest first, reading at most
+    // `maxRows` rows (the keyframe interval). Empty if the task has no
+    // history that old.
+    std::vector<TaskHistoryRow> getTaskHistoryAt(int taskId, std::int64_t atUs, int maxRows);
 };
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "IngestProtocol.h"
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+// --- Little-endian helpers ---
+
+static void put_u8(std::string& out, std::uint8_t v) {
+    out.push_back((char)v);
+}
+
+static void put_u16(std::string& out, std::uint16_t v) {
+    out.push_back((char)(v & 0xFF));
+    out.push_back((char)((v >> 8) & 0xFF));
+}
+
+static void put_u32(std::string& out, std::uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back((char)((v >> (8 * i)) & 0xFF));
+    }
+}
+
+static std::uint16_t get_u16(const char* p) {
+    const unsigned char* u = (const unsigned char*)p;
+    return (std::uint16_t)(u[0] | (u[1] << 8));
+}
+
+static std::uint32_t get_u32(const char* p) {
+    const unsigned char* u = (const unsigned char*)p;
+    return (std::uint32_t)u[0] | ((std::uint32_t)u[1] << 8) |
+           ((std::uint32_t)u[2] << 16) | ((std::uint32_t)u[3] << 24);
+}
+
+// Reads the length prefix. Returns false if the full frame isn't buffered yet.
+static bool frame_available(const char* data, std::size_t len, std::uint32_t& payload_len) {
+    if (len < IngestProtocol::LENGTH_PREFIX_SIZE) {
+        return false;
+    }
+    payload_len = get_u32(data);
+    return len - IngestProtocol::LENGTH_PREFIX_SIZE >= payload_len;
+}
+
+static void store_u16(char* p, std::uint16_t v) {
+    p[0] = (char)(v & 0xFF);
+    p[1] = (char)((v >> 8) & 0xFF);
+}
+
+static void store_u32(char* p, std::uint32_t v) {
+    for (int i = 0; i < 4; i++) {
+        p[i] = (char)((v >> (8 * i)) & 0xFF);
+    }
+}
+
+// Titles longer than a u16 can describe are truncated
+static std::uint16_t title_length(const Task& task) {
+    return task.title.size() > 0xFFFF ? 0xFFFF : (std::uint16_t)task.title.size();
+}
+
+// --- Single task records ---
+
+std::size_t IngestProtocol::record_size(const Task& task) {
+    return 7 + title_length(task) + 4 + task.description.size();
+}
+
+void IngestProtocol::encode_record(const Task& task, char* out) {
+    std::uint16_t title_len = title_length(task);
+    out[0] = (char)(std::uint8_t)task.priority;
+    store_u32(out + 1, (std::uint32_t)task.assignee_id);
+    store_u16(out + 5, title_len);
+    out += 7;
+    std::memcpy(out, task.title.data(), title_len);
+    out += title_len;
+    store_u32(out, (std::uint32_t)task.description.size());
+    std::memcpy(out + 4, task.description.data(), task.description.size());
+}
+
+std::unique_ptr<Task> IngestProtocol::decode_record(const char*& p, const char* end) {
+    if (end - p < 7) return nullptr;
+    int priority = (std::uint8_t)p[0];
+    int assignee_id = (int)get_u32(p + 1);
+    std::uint16_t title_len = get_u16(p + 5);
+    const char* q = p + 7;
+
+    if ((std::size_t)(end - q) < (std::size_t)title_len + 4) return nullptr;
+    std::string title(q, title_len);
+    q += title_len;
+    std::uint32_t desc_len = get_u32(q);
+    q += 4;
+
+    if ((std::size_t)(end - q) < desc_len) return nullptr;
+    std::string desc(q, desc_len);
+    q += desc_len;
+
+    p = q;
+    return std::make_unique<Task>(std::move(title), std::move(desc), priority, "pending", 0, assignee_id);
+}
+
+// --- Client side ---
+
+void IngestProtocol::encode_batch(std::uint32_t batch_seq, const std::vector<Task>& tasks, std::string& out) {
+    if (tasks.size() > MAX_BATCH_TASKS) {
+        throw std::runtime_error("IngestProtocol: batch of " + std::to_string(tasks.size()) +
+                                 " tasks exceeds " + std::to_string(MAX_BATCH_TASKS));
+    }
+    std::size_t start = out.size();
+    put_u32(out, 0); // Length placeholder, patched below
+
+    put_u8(out, MSG_SUBMIT_BATCH);
+    put_u32(out, batch_seq);
+    put_u16(out, (std::uint16_t)tasks.size());
+    for (const Task& t : tasks) {
+        std::size_t at = out.size();
+        out.resize(at + record_size(t));
+        encode_record(t, &out[at]);
+    }
+
+    std::size_t payload_size = out.size() - start - LENGTH_PREFIX_SIZE;
+    if (payload_size > MAX_FRAME_SIZE) {
+        out.resize(start);
+        throw std::runtime_error("IngestProtocol: batch frame exceeds the maximum frame size");
+    }
+    std::uint32_t payload_len = (std::uint32_t)payload_size;
+    for (int i = 0; i < 4; i++) {
+        out[start + i] = (char)((payload_len >> (8 * i)) & 0xFF);
+    }
+}
+
+IngestProtocol::DecodeResult IngestProtocol::decode_ack(const char* data, std::size_t len, std::size_t& consumed,
+                                                        std::uint32_t& batch_seq, std::uint16_t& accepted,
+                                                        std::uint8_t& status) {
+    std::uint32_t payload_len = 0;
+    if (!frame_available(data, len, payload_len)) {
+        return DecodeResult::NeedMore;
+    }
+    const char* p = data + LENGTH_PREFIX_SIZE;
+    if (payload_len != ACK_FRAME_SIZE - LENGTH_PREFIX_SIZE || (std::uint8_t)p[0] != MSG_ACK) {
+        return DecodeResult::Malformed;
+    }
+    batch_seq = get_u32(p + 1);
+    accepted = get_u16(p + 5);
+    status = (std::uint8_t)p[7];
+    consumed = ACK_FRAME_SIZE;
+    return DecodeResult::Complete;
+}
+
+// --- Server side ---
+
+IngestProtocol::DecodeResult IngestProtocol::decode_batch(const char* data, std::size_t len, std::size_t& consumed,
+                                                          std::uint32_t& batch_seq,
+                                                          std::vector<std::unique_ptr<Task>>& out) {
+    if (len >= LENGTH_PREFIX_SIZE && get_u32(data) > MAX_FRAME_SIZE) {
+        return DecodeResult::Malformed;
+    }
+    std::uint32_t payload_len = 0;
+    if (!frame_available(data, len, payload_len)) {
+        return DecodeResult::NeedMore;
+    }
+
+    const char* p = data + LENGTH_PREFIX_SIZE;
+    const char* end = p + payload_len;
+    if (payload_len < 7 || (std::uint8_t)p[0] != MSG_SUBMIT_BATCH) {
+        return DecodeResult::Malformed;
+    }
+    batch_seq = get_u32(p + 1);
+    std::uint16_t count = get_u16(p + 5);
+    p += 7;
+
+    // Decode into a scratch vector so a malformed frame adds nothing
+    std::vector<std::unique_ptr<Task>> batch;
+    batch.reserve(count);
+    auto now = std::chrono::steady_clock::now();
+    bool valid = true;
+    for (std::uint16_t i = 0; i < count; i++) {
+        std::unique_ptr<Task> task = decode_record(p, end);
+        if (!task) return DecodeResult::Malformed;
+        if (task->priority < MIN_PRIORITY || task->priority > MAX_PRIORITY) {
+            valid = false; // Keep decoding so the framing is still checked
+        }
+        task->enqueued_at = now;
+        batch.push_back(std::move(task));
+    }
+    if (p != end) {
+        return DecodeResult::Malformed; // Trailing garbage
+    }
+    consumed = LENGTH_PREFIX_SIZE + payload_len;
+    if (!valid) {
+        return DecodeResult::Rejected;
+    }
+
+    for (auto& task : batch) {
+        out.push_back(std::move(task));
+    }
+    return DecodeResult::Complete;
+}
+
+void IngestProtocol::encode_ack(std::uint32_t batch_seq, std::uint16_t accepted, std::uint8_t status, std::string& out) {
+    put_u32(out, (std::uint32_t)(ACK_FRAME_SIZE - LENGTH_PREFIX_SIZE));
+    put_u8(out, MSG_ACK);
+    put_u32(out, batch_seq);
+    put_u16(out, accepted);
+    put_u8(out, status);
+}
@@ -0,0 +1,99 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../models/Task.h"
+
+/*
+ * Compact length-prefixed binary protocol for pushing tasks into
+ * the TaskManager from other local processes.
+ *
+ * All integers are little-endian. Every frame is:
+ *
+ *   u32 payload_length | payload
+ *
+ * SUBMIT_BATCH payload (client -> server):
+ *   u8  type = MSG_SUBMIT_BATCH
+ *   u32 batch_seq          (echoed back in the ack)
+ *   u16 count
+ *   count x { u8 priority, u32 assignee_id,
+ *             u16 title_len, title bytes,
+ *             u32 desc_len,  description bytes }
+ *
+ * ACK payload (server -> client):
+ *   u8  type = MSG_ACK
+ *   u32 batch_seq
+ *   u16 accepted
+ *   u8  status (ACK_OK / ACK_REJECTED / ACK_RETRY)
+ *
+ * A batch containing a task whose priority is outside
+ * [MIN_PRIORITY, MAX_PRIORITY] is rejected whole: none of its tasks
+ * are accepted and the ack carries ACK_REJECTED with accepted = 0.
+ * A batch the server could not accept for its own reasons (e.g. the
+ * write-ahead log failed) is acked ACK_RETRY with accepted = 0.
+ * A batch holds at most MAX_BATCH_TASKS tasks.
+ *
+ * Clients may pipeline: send many batches without waiting. Acks for
+ * one connection always come back in the order batches were sent.
+ *
+ * The per-task record inside a batch is also used on its own by the
+ * shared-memory submission ring (see ShmSubmissionRing.h).
+ */
+class IngestProtocol {
+public:
+    static const std::uint8_t MSG_SUBMIT_BATCH = 1;
+    static const std::uint8_t MSG_ACK = 2;
+
+    static const std::uint8_t ACK_OK = 0;
+    static const std::uint8_t ACK_REJECTED = 1;
+    static const std::uint8_t ACK_RETRY = 2; // Server could not take it now; resend later
+
+    static const std::size_t LENGTH_PREFIX_SIZE = 4;
+    static const std::size_t ACK_FRAME_SIZE = LENGTH_PREFIX_SIZE + 8;
+    static const std::uint32_t MAX_FRAME_SIZE = 16 * 1024 * 1024;
+    static const std::size_t MAX_BATCH_TASKS = 0xFFFF; // `count` is a u16
+
+    static const int MIN_PRIORITY = 1;
+    static const int MAX_PRIORITY = 5;
+
+    enum class DecodeResult {
+        Complete,  // One frame decoded, `consumed` bytes used
+        NeedMore,  // Not enough bytes buffered yet
+        Rejected,  // Well-formed frame with invalid tasks; `consumed` bytes skipped, nothing added
+        Malformed  // Protocol violation; drop the connection
+    };
+
+    // --- Single task records ---
+
+    // Bytes needed to encode `task` as one record.
+    static std::size_t record_size(const Task& task);
+
+    // Writes one record into `out`, which must hold record_size(task) bytes.
+    static void encode_record(const Task& task, char* out);
+
+    // Decodes one record from [p, end), advancing `p` past it.
+    // Returns nullptr if the record is truncated.
+    static std::unique_ptr<Task> decode_record(const char*& p, const char* end);
+
+    // --- Client side ---
+
+    // Appends one SUBMIT_BATCH frame for `tasks` to `out`. Throws
+    // std::runtime_error (leaving `out` unchanged) if there are more
+    // than MAX_BATCH_TASKS tasks or the frame would exceed MAX_FRAME_SIZE.
+    static void encode_batch(std::uint32_t batch_seq, const std::vector<Task>& tasks, std::string& out);
+
+    static DecodeResult decode_ack(const char* data, std::size_t len, std::size_t& consumed,
+                                   std::uint32_t& batch_seq, std::uint16_t& accepted, std::uint8_t& status);
+
+    // --- Server side ---
+
+    // Decodes one SUBMIT_BATCH frame, appending its tasks to `out`.
+    // Decoded tasks are "pending" and stamped with enqueued_at = now.
+    static DecodeResult decode_batch(const char* data, std::size_t len, std::size_t& consumed,
+                                     std::uint32_t& batch_seq, std::vector<std::unique_ptr<Task>>& out);
+
+    // Appends one ACK frame to `out`.
+    static void encode_ack(std::uint32_t batch_seq, std::uint16_t accepted, std::uint8_t status, std::string& out);
+};
@@ -0,0 +1,322 @@
+#include "IngestServer.h"
+#include "IngestProtocol.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+// POSIX / Linux headers
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static const int MAX_EVENTS = 64;
+static const std::size_t READ_CHUNK = 64 * 1024;
+// Bytes read per pass before decoding; bounds the acks one pass can queue
+static const std::size_t READ_PASS = 256 * 1024;
+
+IngestServer::IngestServer(std::string socket_path, int threads, BatchHandler h)
+    : path(socket_path), num_threads(threads < 1 ? 1 : threads), handler(h),
+      listen_fd(-1), wake_fd(-1), running(false), received(0) {}
+
+IngestServer::~IngestServer() {
+    stop();
+}
+
+bool IngestServer::start() {
+    if (running) {
+        return true;
+    }
+
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(addr.sun_path)) {
+        std::cerr << "[Ingest]: Socket path too long: " << path << std::endl;
+        return false;
+    }
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+
+    listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listen_fd < 0) {
+        std::cerr << "[Ingest]: socket() failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    unlink(path.c_str()); // Remove a stale socket from a previous run
+    if (bind(listen_fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(listen_fd, SOMAXCONN) < 0) {
+        std::cerr << "[Ingest]: Could not listen on " << path << ": " << std::strerror(errno) << std::endl;
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wake_fd < 0) {
+        std::cerr << "[Ingest]: eventfd() failed: " << std::strerror(errno) << std::endl;
+        close(listen_fd);
+        listen_fd = -1;
+        unlink(path.c_str());
+        return false;
+    }
+
+    running = true;
+    for (int i = 0; i < num_threads; i++) {
+        workers.emplace_back(&IngestServer::worker_loop, this);
+    }
+    std::cout << "[Ingest]: Listening on " << path << " with " << num_threads << " threads" << std::endl;
+    return true;
+}
+
+void IngestServer::stop() {
+    if (!running.exchange(false)) {
+        return;
+    }
+
+    // The eventfd stays readable (we never drain it), so every worker wakes up
+    std::uint64_t one = 1;
+    if (write(wake_fd, &one, sizeof(one)) < 0) {
+        std::cerr << "[Ingest]: Failed to wake workers: " << std::strerror(errno) << std::endl;
+    }
+    for (std::thread& t : workers) {
+        t.join();
+    }
+    workers.clear();
+
+    close(wake_fd);
+    close(listen_fd);
+    wake_fd = -1;
+    listen_fd = -1;
+    unlink(path.c_str());
+    std::cout << "[Ingest]: Stopped after receiving " << tasks_received() << " tasks" << std::endl;
+}
+
+// --- Worker ---
+
+void IngestServer::worker_loop() {
+    int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (epoll_fd < 0) {
+        std::cerr << "[Ingest]: epoll_create1() failed: " << std::strerror(errno) << std::endl;
+        return;
+    }
+
+    // The two shared fds are tagged with the address of the member
+    // holding them; every other event carries a Connection*
+    epoll_event ev;
+    std::memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = &wake_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, wake_fd, &ev);
+
+    ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+    ev.data.ptr = &listen_fd;
+    epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev);
+
+    std::vector<Connection*> conns; // Connections owned by this worker
+    epoll_event events[MAX_EVENTS];
+
+    while (running) {
+        int n = epoll_wait(epoll_fd, events, MAX_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            std::cerr << "[Ingest]: epoll_wait() failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.ptr == &wake_fd) {
+                continue; // `running` is false; loop condition exits
+            }
+            if (events[i].data.ptr == &listen_fd) {
+                accept_connections(epoll_fd, conns);
+                continue;
+            }
+
+            Connection* c = (Connection*)events[i].data.ptr;
+            bool keep = true;
+            if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+                keep = handle_readable(c);
+            }
+            // Always try to flush: reads may have queued acks. A client
+            // that half-closed is dropped once it has all of its acks.
+            if (!keep || !flush(epoll_fd, c) || (c->peer_closed && c->out.empty())) {
+                close_connection(epoll_fd, c, conns);
+            }
+        }
+    }
+
+    while (!conns.empty()) {
+        close_connection(epoll_fd, conns.back(), conns);
+    }
+    close(epoll_fd);
+}
+
+void IngestServer::accept_connections(int epoll_fd, std::vector<Connection*>& conns) {
+    while (true) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::cerr << "[Ingest]: accept4() failed: " << std::strerror(errno) << std::endl;
+            }
+            return;
+        }
+
+        Connection* c = new Connection(fd);
+        epoll_event ev;
+        std::memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+        ev.data.ptr = c;
+        if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            std::cerr << "[Ingest]: epoll_ctl() failed: " << std::strerror(errno) << std::endl;
+            close(fd);
+            delete c;
+            continue;
+        }
+        conns.push_back(c);
+    }
+}
+
+/*
+ * Drains the socket (edge-triggered) in passes of about READ_PASS
+ * bytes, decoding the complete frames after each pass. c->in then
+ * holds at most one partial frame (<= MAX_FRAME_SIZE) plus one pass.
+ * Stops early, leaving the rest in the socket, once too many
+ * acks are pending; flush() re-arms EPOLLIN when they have drained.
+ * Returns false if the connection should be closed.
+ */
+bool IngestServer::handle_readable(Connection* c) {
+    char buf[READ_CHUNK];
+    while (c->out.size() < MAX_PENDING_OUTPUT) {
+        bool drained = false;
+        std::size_t pass_start = c->in.size();
+        while (c->in.size() - pass_start < READ_PASS) {
+            ssize_t r = read(c->fd, buf, sizeof(buf));
+            if (r > 0) {
+                c->in.append(buf, (std::size_t)r);
+            } else if (r == 0) {
+                c->peer_closed = true;
+                drained = true;
+                break;
+            } else if (errno == EINTR) {
+                continue;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                drained = true;
+                break;
+            } else {
+                return false;
+            }
+        }
+
+        if (!decode_frames(c)) {
+            return false;
+        }
+        if (drained) {
+            return true;
+        }
+    }
+    c->want_read = false; // The edge was consumed without draining the socket
+    return true;
+}
+
+/*
+ * Decodes every complete frame in c->in, hands all their tasks to the
+ * handler in one call, then queues one ack per frame (ACK_RETRY for
+ * all of them if the handler refused the tasks). Returns false
+ * on a malformed frame.
+ */
+bool IngestServer::decode_frames(Connection* c) {
+    struct Ack {
+        std::uint32_t batch_seq;
+        std::uint16_t accepted;
+        std::uint8_t status;
+    };
+    std::vector<std::unique_ptr<Task>> batch;
+    std::vector<Ack> acks;
+    std::size_t offset = 0;
+    bool malformed = false;
+
+    while (offset < c->in.size()) {
+        std::size_t consumed = 0;
+        std::uint32_t seq = 0;
+        std::size_t before = batch.size();
+        IngestProtocol::DecodeResult res = IngestProtocol::decode_batch(
+            c->in.data() + offset, c->in.size() - offset, consumed, seq, batch);
+
+        if (res == IngestProtocol::DecodeResult::NeedMore) break;
+        if (res == IngestProtocol::DecodeResult::Malformed) {
+            std::cerr << "[Ingest]: Malformed frame, dropping connection" << std::endl;
+            malformed = true;
+            break;
+        }
+        if (res == IngestProtocol::DecodeResult::Rejected) {
+            acks.push_back({seq, 0, IngestProtocol::ACK_REJECTED});
+        } else {
+            acks.push_back({seq, (std::uint16_t)(batch.size() - before), IngestProtocol::ACK_OK});
+        }
+        offset += consumed;
+    }
+    c->in.erase(0, offset);
+
+    bool accepted = true;
+    if (!batch.empty()) {
+        std::size_t count = batch.size();
+        accepted = handler(batch);
+        if (accepted) {
+            received.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+    for (const Ack& ack : acks) {
+        if (!accepted && ack.status == IngestProtocol::ACK_OK) {
+            IngestProtocol::encode_ack(ack.batch_seq, 0, IngestProtocol::ACK_RETRY, c->out);
+        } else {
+            IngestProtocol::encode_ack(ack.batch_seq, ack.accepted, ack.status, c->out);
+        }
+    }
+
+    return !malformed;
+}
+
+// Writes as much of the pending output as the socket accepts.
+// Returns false on a write error.
+bool IngestServer::flush(int epoll_fd, Connection* c) {
+    std::size_t written = 0;
+    while (written < c->out.size()) {
+        ssize_t w = send(c->fd, c->out.data() + written, c->out.size() - written, MSG_NOSIGNAL);
+        if (w > 0) {
+            written += (std::size_t)w;
+        } else if (w < 0 && errno == EINTR) {
+            continue;
+        } else if (w < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            return false;
+        }
+    }
+    c->out.erase(0, written);
+
+    // Arm EPOLLOUT only while there is something left to write, and
+    // EPOLLIN only while the client is not too far behind on its acks.
+    // Re-arming an edge-triggered fd reports data already waiting.
+    bool need_write = !c->out.empty();
+    bool need_read = !c->peer_closed && c->out.size() < MAX_PENDING_OUTPUT;
+    if (need_write != c->want_write || need_read != c->want_read) {
+        epoll_event ev;
+        std::memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLET | (need_read ? (std::uint32_t)(EPOLLIN | EPOLLRDHUP) : 0u) |
+                    (need_write ? (std::uint32_t)EPOLLOUT : 0u);
+        ev.data.ptr = c;
+        epoll_ctl(epoll_fd, EPOLL_CTL_MOD, c->fd, &ev);
+        c->want_write = need_write;
+        c->want_read = need_read;
+    }
+    return true;
+}
+
+void IngestServer::close_connection(int epoll_fd, Connection* c, std::vector<Connection*>& conns) {
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, c->fd, nullptr);
+    close(c->fd);
+    conns.erase(std::remove(conns.begin(), conns.end(), c), conns.end());
+    delete c;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../models/Task.h"
+
+/*
+ * Local ingestion server on a Unix-domain socket.
+ *
+ * Speaks the IngestProtocol (see IngestProtocol.h). A small, fixed
+ * number of worker threads each run their own epoll loop; they
+ * share the listening socket (EPOLLEXCLUSIVE) so only one worker is
+ * woken per incoming connection.
+ *
+ * Every frame decoded during one read pass on a connection is handed
+ * to `handler` as a single batch, and only then are the acks queued.
+ * This amortizes locking in the handler and means an ACK_OK always
+ * implies the handler accepted the tasks. If the handler returns
+ * false, every frame of that pass is acked ACK_RETRY instead.
+ *
+ * Per-connection buffers are bounded: a connection stops being read
+ * (EPOLLIN is dropped) while it has MAX_PENDING_OUTPUT bytes of acks
+ * the client has not picked up, and input is decoded every few
+ * hundred KiB, so at most one partial frame stays buffered. After the client
+ * shuts down its write side, pending acks are still flushed before
+ * the connection is closed.
+ */
+class IngestServer {
+public:
+    // Takes ownership of the tasks (it may move them out of the vector).
+    // Returns false if it could not accept them.
+    using BatchHandler = std::function<bool(std::vector<std::unique_ptr<Task>>&)>;
+
+    IngestServer(std::string socket_path, int num_threads, BatchHandler handler);
+    ~IngestServer();
+
+    // Binds the socket and starts the worker threads.
+    // Returns false (and logs why) if the socket could not be set up.
+    bool start();
+
+    // Wakes and joins all workers, closes every connection and
+    // removes the socket file. Safe to call more than once.
+    void stop();
+
+    std::uint64_t tasks_received() const { return received.load(std::memory_order_relaxed); }
+
+    static const std::size_t MAX_PENDING_OUTPUT = 1024 * 1024;
+
+private:
+    struct Connection {
+        int fd;
+        std::string in;   // Bytes read but not yet decoded
+        std::string out;  // Encoded acks not yet written
+        bool want_write;  // EPOLLOUT currently armed
+        bool want_read;   // EPOLLIN armed and its edge not consumed yet
+        bool peer_closed; // Client shut down its write side
+
+        explicit Connection(int f) : fd(f), want_write(false), want_read(true), peer_closed(false) {}
+    };
+
+    std::string path;
+    int num_threads;
+    BatchHandler handler;
+
+    int listen_fd;
+    int wake_fd; // eventfd used to interrupt epoll_wait on stop()
+    std::vector<std::thread> workers;
+    std::atomic<bool> running;
+    std::atomic<std::uint64_t> received;
+
+    void worker_loop();
+    void accept_connections(int epoll_fd, std::vector<Connection*>& conns);
+    bool handle_readable(Connection* c);
+    bool decode_frames(Connection* c);
+    bool flush(int epoll_fd, Connection* c);
+    void close_connection(int epoll_fd, Connection* c, std::vector<Connection*>& conns);
+};
@@ -0,0 +1,222 @@
+#include "ShmSubmissionRing.h"
+#include "IngestProtocol.h"
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+// POSIX headers
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "Shared-memory atomics must be lock-free to be process-shared");
+
+static const std::uint32_t RING_MAGIC = 0x42574452; // "BWDR"
+static const std::uint32_t RING_VERSION = 1;
+static const std::size_t CACHE_LINE = 64;
+
+/*
+ * Lives at the start of the segment. head and tail sit on their own
+ * cache lines so producers and the consumer don't false-share.
+ */
+struct ShmSubmissionRing::Header {
+    std::atomic<std::uint32_t> magic; // Written last by create()
+    std::uint32_t version;
+    std::uint32_t capacity;   // Number of slots (power of two)
+    std::uint32_t slot_size;  // Bytes per slot, including the Slot header
+    alignas(CACHE_LINE) std::atomic<std::uint64_t> tail; // Next position producers claim
+    alignas(CACHE_LINE) std::atomic<std::uint64_t> head; // Next position the consumer reads
+};
+
+struct ShmSubmissionRing::Slot {
+    std::atomic<std::uint64_t> sequence;
+    std::uint32_t length; // Bytes of record data following the Slot header
+    std::uint32_t reserved;
+    // char record[slot_size - sizeof(Slot)] follows
+};
+
+static std::size_t round_up(std::size_t v, std::size_t to) {
+    return (v + to - 1) / to * to;
+}
+
+std::size_t ShmSubmissionRing::header_bytes() {
+    return round_up(sizeof(Header), CACHE_LINE);
+}
+
+ShmSubmissionRing::ShmSubmissionRing(std::string n, bool o, void* b, std::size_t size,
+                                     std::uint32_t capacity, std::uint32_t slot_size)
+    : name(n), owner(o), base(b), mapped_size(size),
+      header((Header*)b), slots((char*)b + header_bytes()), cap(capacity), stride(slot_size) {}
+
+ShmSubmissionRing::~ShmSubmissionRing() {
+    munmap(base, mapped_size);
+    if (owner) {
+        shm_unlink(name.c_str());
+    }
+}
+
+std::unique_ptr<ShmSubmissionRing> ShmSubmissionRing::create(const std::string& name, std::uint32_t capacity,
+                                                             std::uint32_t slot_size) {
+    std::uint32_t cap = 1;
+    while (cap < capacity) cap <<= 1;
+    std::size_t stride = round_up(slot_size < sizeof(Slot) + 8 ? sizeof(Slot) + 8 : slot_size, CACHE_LINE);
+    std::size_t size = header_bytes() + (std::size_t)cap * stride;
+
+    shm_unlink(name.c_str()); // Start from a clean segment
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "[ShmRing]: shm_open(" << name << ") failed: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    if (ftruncate(fd, (off_t)size) < 0) {
+        std::cerr << "[ShmRing]: ftruncate failed: " << std::strerror(errno) << std::endl;
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "[ShmRing]: mmap failed: " << std::strerror(errno) << std::endl;
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    Header* h = new (base) Header();
+    h->version = RING_VERSION;
+    h->capacity = cap;
+    h->slot_size = (std::uint32_t)stride;
+    h->tail.store(0, std::memory_order_relaxed);
+    h->head.store(0, std::memory_order_relaxed);
+
+    std::unique_ptr<ShmSubmissionRing> ring(new ShmSubmissionRing(name, true, base, size, cap, (std::uint32_t)stride));
+    for (std::uint64_t i = 0; i < cap; i++) {
+        Slot* s = new (ring->slot_at(i)) Slot();
+        s->sequence.store(i, std::memory_order_relaxed);
+    }
+    // Publish: producers refuse to attach until the magic is visible
+    h->magic.store(RING_MAGIC, std::memory_order_release);
+
+    std::cout << "[ShmRing]: Created " << name << " with " << cap << " slots of " << stride << " bytes" << std::endl;
+    return ring;
+}
+
+std::unique_ptr<ShmSubmissionRing> ShmSubmissionRing::open(const std::string& name) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        std::cerr << "[ShmRing]: shm_open(" << name << ") failed: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (std::size_t)st.st_size < header_bytes()) {
+        std::cerr << "[ShmRing]: Segment " << name << " is not initialized" << std::endl;
+        close(fd);
+        return nullptr;
+    }
+    std::size_t size = (std::size_t)st.st_size;
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "[ShmRing]: mmap failed: " << std::strerror(errno) << std::endl;
+        return nullptr;
+    }
+
+    Header* h = (Header*)base;
+    std::uint32_t cap = h->capacity;
+    std::uint32_t stride = h->slot_size;
+    // slot_at() masks with capacity - 1, so it must be a power of two
+    bool pow2 = cap != 0 && (cap & (cap - 1)) == 0;
+    if (h->magic.load(std::memory_order_acquire) != RING_MAGIC || h->version != RING_VERSION || !pow2 ||
+        stride < sizeof(Slot) || header_bytes() + (std::size_t)cap * stride > size) {
+        std::cerr << "[ShmRing]: Segment " << name << " has an unexpected layout" << std::endl;
+        munmap(base, size);
+        return nullptr;
+    }
+    return std::unique_ptr<ShmSubmissionRing>(new ShmSubmissionRing(name, false, base, size, cap, stride));
+}
+
+ShmSubmissionRing::Slot* ShmSubmissionRing::slot_at(std::uint64_t pos) const {
+    std::uint64_t index = pos & (cap - 1);
+    return (Slot*)(slots + index * stride);
+}
+
+std::uint32_t ShmSubmissionRing::capacity() const {
+    return cap;
+}
+
+std::uint32_t ShmSubmissionRing::max_record_size() const {
+    return stride - (std::uint32_t)sizeof(Slot);
+}
+
+bool ShmSubmissionRing::try_submit(const Task& task) {
+    std::size_t len = IngestProtocol::record_size(task);
+    if (len > max_record_size()) {
+        return false;
+    }
+
+    std::uint64_t pos = header->tail.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+        slot = slot_at(pos);
+        std::uint64_t seq = slot->sequence.load(std::memory_order_acquire);
+        std::int64_t diff = (std::int64_t)(seq - pos);
+        if (diff == 0) {
+            // Slot is free for this position; try to claim it
+            if (header->tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false; // Consumer hasn't released this slot: ring is full
+        } else {
+            pos = header->tail.load(std::memory_order_relaxed); // Another producer won
+        }
+    }
+
+    IngestProtocol::encode_record(task, (char*)(slot + 1));
+    slot->length = (std::uint32_t)len;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+std::size_t ShmSubmissionRing::drain(std::vector<std::unique_ptr<Task>>& out, std::size_t max_tasks) {
+    std::uint64_t pos = header->head.load(std::memory_order_relaxed);
+    std::size_t drained = 0;
+    auto now = std::chrono::steady_clock::now();
+
+    while (drained < max_tasks) {
+        Slot* slot = slot_at(pos);
+        if (slot->sequence.load(std::memory_order_acquire) != pos + 1) {
+            break; // Not yet published
+        }
+
+        // The length comes from another process: read it once and make
+        // sure it stays inside the slot before decoding
+        const char* p = (const char*)(slot + 1);
+        std::uint32_t length = slot->length;
+        std::unique_ptr<Task> task;
+        if (length <= max_record_size()) {
+            task = IngestProtocol::decode_record(p, p + length);
+        }
+        if (!task) {
+            std::cerr << "[ShmRing]: Dropping corrupt record at position " << pos << std::endl;
+        } else if (task->priority < IngestProtocol::MIN_PRIORITY || task->priority > IngestProtocol::MAX_PRIORITY) {
+            // Same range the socket path enforces
+            std::cerr << "[ShmRing]: Dropping record with priority " << task->priority << " at position " << pos
+                      << std::endl;
+        } else {
+            task->enqueued_at = now;
+            out.push_back(std::move(task));
+        }
+
+        // Hand the slot back to producers for the next lap
+        slot->sequence.store(pos + cap, std::memory_order_release);
+        pos++;
+        drained++;
+    }
+    header->head.store(pos, std::memory_order_relaxed);
+    return drained;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../models/Task.h"
+
+/*
+ * Multi-producer, single-consumer ring buffer in POSIX shared memory
+ * (shm_open + mmap) for co-located producer processes.
+ *
+ * Producers write Tasks straight into a slot using the IngestProtocol
+ * record format; no syscall happens on the submit path, only a CAS on
+ * the shared tail and a release-store on the slot sequence.
+ * TaskManager is the single consumer and drains slots into
+ * new_task_queue.
+ *
+ * Each slot carries a sequence number (the classic bounded MPMC
+ * scheme): a producer may claim position `pos` when the slot's
+ * sequence equals `pos`, and publishes it by storing `pos + 1`. The
+ * consumer releases it back by storing `pos + capacity`.
+ *
+ * Caveat: a producer that dies between claiming and publishing a slot
+ * stalls the consumer at that slot until the ring is recreated.
+ */
+class ShmSubmissionRing {
+public:
+    // Consumer side: creates (or replaces) the segment `name` (e.g.
+    // "/buildwithdata_ring"). `capacity` is rounded up to a power of
+    // two. The segment is unlinked when the returned ring is destroyed.
+    // Returns nullptr (and logs why) on failure.
+    static std::unique_ptr<ShmSubmissionRing> create(const std::string& name, std::uint32_t capacity,
+                                                     std::uint32_t slot_size = 512);
+
+    // Producer side: maps an existing segment created by create().
+    static std::unique_ptr<ShmSubmissionRing> open(const std::string& name);
+
+    ~ShmSubmissionRing();
+
+    // Producer: copies `task` into the next free slot.
+    // Returns false if the ring is full or the task doesn't fit a slot.
+    // Complexity: O(1), lock-free
+    bool try_submit(const Task& task);
+
+    // Consumer: moves up to `max_tasks` published tasks into `out`,
+    // stamping their enqueued_at. Corrupt records and priorities
+    // outside IngestProtocol's range are logged and dropped. Returns
+    // how many slots were drained.
+    // Must only be called from one thread at a time.
+    std::size_t drain(std::vector<std::unique_ptr<Task>>& out, std::size_t max_tasks);
+
+    std::uint32_t capacity() const;
+    std::uint32_t max_record_size() const;
+
+private:
+    struct Header;
+    struct Slot;
+
+    std::string name;
+    bool owner;        // Unlinks the segment on destruction
+    void* base;
+    std::size_t mapped_size;
+    Header* header;
+    char* slots;
+    // Validated copies of the header's geometry, so a misbehaving
+    // process can't change it under us afterwards
+    std::uint32_t cap;
+    std::uint32_t stride;
+
+    ShmSubmissionRing(std::string name, bool owner, void* base, std::size_t size,
+                      std::uint32_t capacity, std::uint32_t slot_size);
+    static std::size_t header_bytes();
+    Slot* slot_at(std::uint64_t pos) const;
+};
@@ -4,14 +4,29 @@
 #include <memory> // For smart pointers
 #include <thread> // For std::this_thread::sleep_for
 #include <chrono> // For std::chrono::milliseconds
+#include <memory_resource> // Node pool for new_task_queue
+#include <optional>
+#include <atomic> // Trace subscriber's latency
+#include <algorithm> // For std::find_if
 
 // Project includes
 #include "../db/DatabaseConnector.h"
 #include "../models/Task.h"
 #include "../models/UndoAction.h"
 #include "../data_structures/Queue.h"
+#include "../data_structures/BlockingQueue.h"
 #include "../data_structures/Stack.h"
-#include "../data_structures/PriorityQueue.h"
+#include "../data_structures/PersistentPriorityQueue.h"
+#include "../metrics/WaitTimeHistogram.h"
+#include "../metrics/TaskCounters.h"
+#include "../ingest/IngestServer.h"
+#include "../ingest/ShmSubmissionRing.h"
+#include "../storage/WriteAheadLog.h"
+#include "../storage/ColumnarFile.h"
+#include "../storage/TaskHistory.h"
+#include "../cache/TaskCache.h"
+#include "../scheduler/SchedulerWindow.h"
+#include "../scheduler/TaskEventBus.h"
 
 // --- Configuration ---
 const std::string DB_HOST = "localhost";
@@ -19,6 +34,37 @@ const std::string DB_USER = "root";
 const std::string DB_PASS = "YOUR_MYSQL_PASSWORD"; // <-- CHANGE THIS
 const std::string DB_NAME = "buildwithdata_db";
 
+// Read replicas for heavy read-only work, e.g. {"tcp://127.0.0.1:3307"}
+// (same user/password/schema). Skipped while lagging more than this.
+const std::vector<std::string> DB_READ_REPLICAS = {};
+const int REPLICA_MAX_LAG_SECONDS = 2;
+
+// Alert when the p99 wait of any priority level exceeds this
+const std::chrono::microseconds STARVATION_THRESHOLD = std::chrono::seconds(5);
+
+// Local ingestion server (see ingest/IngestProtocol.h)
+const std::string INGEST_SOCKET_PATH = "/tmp/buildwithdata_ingest.sock";
+const int INGEST_THREADS = 2;
+
+// Shared-memory submission ring for co-located producer processes
+const std::string SHM_RING_NAME = "/buildwithdata_ring";
+const std::uint32_t SHM_RING_CAPACITY = 65536;
+
+// Write-ahead log making submitted tasks durable before MySQL
+const std::string WAL_DIR = "./wal";
+
+// Windowed scheduler: hold only this many pending tasks in memory and
+// refill from the DB below the low watermark. 0 = load the whole backlog.
+const std::size_t SCHEDULER_WINDOW_SIZE = 0;
+const std::size_t SCHEDULER_LOW_WATERMARK = 250;
+
+// INSERT attempts per task before it is set aside (see WriteAheadLog::mark_failed)
+const int PERSIST_ATTEMPTS = 3;
+
+// How long the queue processor waits for more submissions before
+// deciding the queue is drained
+const std::chrono::milliseconds QUEUE_IDLE_TIMEOUT(100);
+
 
 void separator(std::string title) {
     std::cout << "\n" << std::string(25, '=') << " " << title << " " << std::string(25, '=') << std::endl;
@@ -32,46 +78,223 @@ void separator(std::string title) {
  * has *unique ownership* of the new task data.
  * - `std::shared_ptr<Task>`: For the priority queue. Multiple
  * parts of the system might (in theory) refer to a task
- * that is actively being processed.
+ * that is actively being processed. The scheduler is a
+ * persistent heap, so readers can take O(1) snapshots of it.
  * - `UndoAction`: This is a simple struct, so we store it
  * by value in the stack.
+ *
+ * It also records how long each task waits in every stage,
+ * per priority level, in `wait_times`, and keeps per-status,
+ * per-priority and per-assignee task counts in `counters`.
+ *
+ * `new_task_queue` can be fed from other threads (the
+ * IngestServer), so it is a BlockingQueue: the processor parks on
+ * it instead of polling, and wakes as soon as a task arrives.
+ * Its nodes are recycled through `queue_pool` instead of going
+ * to the global heap for every submitted task.
+ * Tasks written by other processes into the shared-memory
+ * `submission_ring` are drained into it before processing.
+ *
+ * When a `wal` is attached, submit_new_task and submit_tasks only
+ * enqueue tasks after they are durable in the log (and refuse them
+ * if the log can't be written), and the log is told once each task
+ * has been persisted to MySQL.
+ *
+ * When a `window` is attached, the scheduler runs in windowed mode:
+ * tasks come from the SchedulerWindow (top K, refilled from the DB)
+ * instead of loading every pending task into `task_scheduler`.
+ *
+ * Task creation and the status transitions made by the scheduler
+ * (and undo) are published on `events`. The counters, the undo log
+ * and the task `history` (when attached) are subscribers, so they are
+ * updated off the executor's thread; a trace subscriber runs after
+ * them and measures how long the whole pipeline takes. Anything
+ * reading `counters` or `undo_stack` flushes the bus first.
  */
 class TaskManager {
 private:
     DatabaseConnector* db;
-    Queue<std::unique_ptr<Task>> new_task_queue;
-    PriorityQueue<std::shared_ptr<Task>, int> task_scheduler;
+    std::pmr::unsynchronized_pool_resource queue_pool; // Only touched under new_task_queue's lock
+    PmrBlockingQueue<std::unique_ptr<Task>> new_task_queue{&queue_pool};
+    ShmSubmissionRing* submission_ring = nullptr; // Not owned
+    WriteAheadLog* wal = nullptr;                 // Not owned
+    SchedulerWindow* window = nullptr;            // Not owned
+    TaskHistory* history = nullptr;               // Not owned
+    PersistentPriorityQueue<std::shared_ptr<Task>, int> task_scheduler;
     Stack<UndoAction> undo_stack;
+    WaitTimeTracker wait_times;
+    TaskCounters counters;
+    std::atomic<std::int64_t> max_event_latency_us{0}; // Written by the trace subscriber
+    TaskEventBus events; // Declared last: its threads use the members above
+
+    // Hook the counters, the undo log, the history and tracing up to `events`
+    void subscribe_to_events() {
+        int counts = events.subscribe("counters", [this](const TaskEvent& e, bool) {
+            if (e.type == TaskEventType::Created) {
+                counters.on_created(e.new_status, e.priority, e.assignee_id);
+            } else {
+                counters.on_status_changed(e.old_status, e.new_status, e.priority, e.assignee_id);
+            }
+        });
+        int undo = events.subscribe("undo", [this](const TaskEvent& e, bool) {
+            if (e.type != TaskEventType::Started) return;
+            // We PUSH the "undo" operation onto the IN-MEMORY STACK
+            std::map<std::string, std::string> data;
+            data["task_id"] = std::to_string(e.task_id);
+            data["old_status"] = e.old_status;
+            data["priority"] = std::to_string(e.priority);
+            data["assignee_id"] = std::to_string(e.assignee_id);
+            undo_stack.push(UndoAction("update_status", data));
+        });
+        // Rows are buffered and written to TaskHistory in batches
+        int versions = events.subscribe("history", [this](const TaskEvent& e, bool) {
+            if (history) history->record(e.task_id, e.new_status, e.priority, e.changed_at_us);
+        });
+        events.subscribe("trace", [this](const TaskEvent& e, bool) {
+            std::int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - e.published_at).count();
+            if (us > max_event_latency_us.load(std::memory_order_relaxed)) {
+                max_event_latency_us.store(us, std::memory_order_relaxed);
+            }
+        }, {counts, undo, versions});
+        events.start();
+    }
 
 public:
-    TaskManager(DatabaseConnector* db_conn) : db(db_conn) {
+    TaskManager(DatabaseConnector* db_conn) : db(db_conn), wait_times(STARVATION_THRESHOLD) {
+        subscribe_to_events();
         std::cout << "TaskManager initialized with Queue, PriorityQueue, and Stack." << std::endl;
     }
 
     // Step 1: Submit new task to IN-MEMORY QUEUE
-    void submit_new_task(std::string title, std::string desc, int priority, int user_id = 1) {
+    // Returns false if the task could not be made durable (not enqueued)
+    bool submit_new_task(std::string title, std::string desc, int priority, int user_id = 1) {
         std::cout << "\nUser submitted new task: '" << title << "'" << std::endl;
         
         // Use std::make_unique to create a smart pointer for the new task
         auto task_ptr = std::make_unique<Task>(title, desc, priority, "pending", 0, user_id);
+        task_ptr->enqueued_at = std::chrono::steady_clock::now();
+
+        // Make the task durable before anyone can see it
+        if (wal) {
+            task_ptr->wal_lsn = wal->append(*task_ptr);
+            if (task_ptr->wal_lsn == 0) {
+                std::cerr << "[WAL]: Could not log '" << title << "', not enqueuing it" << std::endl;
+                return false;
+            }
+        }
         
         // Move ownership of the pointer into the queue
-        new_task_queue.enqueue(std::move(task_ptr));
+        new_task_queue.push(std::move(task_ptr));
         std::cout << "[Queue]: Enqueued " << title << std::endl;
+        return true;
+    }
+
+    // Step 1b: Submit a whole batch at once (used by the IngestServer).
+    // Takes the lock once per batch instead of once per task, and
+    // logs the batch with one WAL write + sync before anyone sees it
+    // Returns false, leaving `tasks` untouched and nothing enqueued,
+    // if the batch could not be made durable.
+    bool submit_tasks(std::vector<std::unique_ptr<Task>>& tasks) {
+        if (wal && !wal->append_batch(tasks)) {
+            std::cerr << "[WAL]: Could not log a batch of " << tasks.size() << " tasks, not enqueuing it" << std::endl;
+            return false;
+        }
+        new_task_queue.push_all(tasks);
+        return true;
+    }
+
+    void attach_submission_ring(ShmSubmissionRing* ring) {
+        submission_ring = ring;
+    }
+
+    // Replays tasks that were logged but never persisted (from
+    // WriteAheadLog::open) and logs every new submission from now on.
+    void attach_wal(WriteAheadLog* log, std::vector<std::unique_ptr<Task>>& recovered) {
+        wal = log;
+        if (!recovered.empty()) {
+            std::cout << "[WAL]: Replaying " << recovered.size() << " tasks into the queue" << std::endl;
+            new_task_queue.push_all(recovered); // Already durable
+
+        }
+    }
+
+    // Record every task version from now on (see TaskHistory.h).
+    // Must be attached before any task is submitted.
+    void attach_history(TaskHistory* h) {
+        history = h;
+    }
+
+    // Switch the scheduler to windowed mode (see SchedulerWindow.h)
+    void attach_window(SchedulerWindow* w) {
+        window = w;
+    }
+
+    // Step 1c: Move everything producers wrote into the shared-memory
+    // ring over to new_task_queue. Returns how many tasks were moved.
+    std::size_t drain_submission_ring() {
+        if (!submission_ring) return 0;
+        std::vector<std::unique_ptr<Task>> batch;
+        std::size_t total = 0;
+        while (submission_ring->drain(batch, 1024) > 0) {
+            std::cout << "[ShmRing]: Drained " << batch.size() << " tasks" << std::endl;
+            total += batch.size();
+            // The slots are already free and producers get no ack, so
+            // keeping the tasks unlogged beats dropping them
+            if (!submit_tasks(batch)) {
+                std::cerr << "[ShmRing]: Queueing " << batch.size() << " tasks without the WAL" << std::endl;
+                new_task_queue.push_all(batch);
+            }
+        }
+        return total;
     }
 
     // Step 2: Process queue -> PERSISTENT DATABASE
     void process_new_task_queue() {
         separator("Processing New Task Queue");
-        while (!new_task_queue.isEmpty()) {
-            // Dequeue gives us ownership of the unique_ptr
-            std::unique_ptr<Task> task_to_save = new_task_queue.dequeue();
+        while (true) {
+            // Producers in other processes can't wake us, so pick up
+            // whatever they wrote before every pop
+            drain_submission_ring();
+            // Popping gives us ownership of the unique_ptr. Waits
+            // (without spinning the CPU) for late submissions.
+            std::optional<std::unique_ptr<Task>> next = new_task_queue.pop_wait_for(QUEUE_IDLE_TIMEOUT);
+            if (!next) {
+                // Idle: only stop if the ring stayed empty meanwhile too
+                if (drain_submission_ring() > 0) continue;
+                break;
+            }
+            std::unique_ptr<Task> task_to_save = std::move(*next);
+            wait_times.record(TaskStage::Queue, task_to_save->priority,
+                              std::chrono::steady_clock::now() - task_to_save->enqueued_at);
             
             std::cout << "Processor: Saving '" << task_to_save->title << "' to database..." << std::endl;
             
             // Pass the raw pointer to the DB. The .get() method
-            // does *not* release ownership.
-            db->createTask(task_to_save.get());
+            // does *not* release ownership. Transient errors get a
+            // few retries with a growing pause.
+            Task* saved = nullptr;
+            for (int attempt = 1; attempt <= PERSIST_ATTEMPTS && !saved; attempt++) {
+                if (attempt > 1) {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(100 * attempt));
+                }
+                saved = db->createTask(task_to_save.get());
+            }
+
+            if (saved) {
+                events.publish(TaskEventType::Created, *saved, "", saved->status);
+                if (window) window->offer(*saved);
+            }
+
+            // Now in MySQL, so the log no longer needs it. A task that
+            // still failed is set aside so it can't stall the log.
+            if (wal && task_to_save->wal_lsn != 0) {
+                if (saved) {
+                    wal->mark_persisted(task_to_save->wal_lsn);
+                } else {
+                    wal->mark_failed(*task_to_save);
+                }
+            }
             
             std::this_thread::sleep_for(std::chrono::milliseconds(500));
             
@@ -84,6 +307,11 @@ public:
     // Step 3: Load from DB -> IN-MEMORY PRIORITY QUEUE
     void load_tasks_into_scheduler() {
         separator("Loading Pending Tasks into Scheduler");
+        if (window) {
+            // Only the head of the backlog is fetched, in the background
+            window->start();
+            return;
+        }
         std::cout << "Fetching 'pending' tasks from database..." << std::endl;
         
         // DB returns a vector of raw pointers (it owns this memory)
@@ -96,26 +324,58 @@ public:
 
         std::cout << "Found " << pending_tasks.size() << " pending tasks. Loading into PriorityQueue..." << std::endl;
         
+        // Rows arrive ORDER BY priority, so bulk_load builds the heap
+        // in O(n) instead of n separate O(log n) inserts
+        std::vector<std::pair<int, std::shared_ptr<Task>>> items;
+        items.reserve(pending_tasks.size());
+        auto now = std::chrono::steady_clock::now();
         for (Task* task_ptr : pending_tasks) {
             // Create a shared_ptr to manage this task's lifetime.
             // The Priority Queue will now "own" this task.
             std::shared_ptr<Task> task_sptr(task_ptr);
-            task_scheduler.insert(task_sptr, task_sptr->priority);
+            task_sptr->scheduled_at = now;
+            items.emplace_back(task_sptr->priority, task_sptr);
             
             std::cout << "[P-Queue]: Inserted '" << task_sptr->title << "' with priority " << task_sptr->priority << std::endl;
-            std::this_thread::sleep_for(std::chrono::milliseconds(200));
         }
+        task_scheduler.bulk_load(std::move(items));
         std::cout << "Task Scheduler is loaded." << std::endl;
     }
 
+    // Consistent read-only view of everything waiting in the scheduler,
+    // for dashboards and admin tools. Safe to call from any thread
+    // while run_task_scheduler keeps going. The Task objects are shared
+    // with the executor, so readers should stick to id/title/priority.
+    PersistentPriorityQueue<std::shared_ptr<Task>, int>::Snapshot scheduler_snapshot() const {
+        return task_scheduler.snapshot();
+    }
+
+    // Step 3b: Peek at the scheduler without locking or draining it
+    void show_scheduler_snapshot(std::size_t k = 3) {
+        separator("Scheduler Snapshot");
+        auto snap = scheduler_snapshot();
+        std::cout << "[Snapshot]: " << snap.size() << " tasks waiting. Next " << k << ":" << std::endl;
+        for (const auto& item : snap.top(k)) {
+            std::cout << "  (Priority " << item.first << ") '" << item.second->title << "'" << std::endl;
+        }
+    }
+
     // Step 4: Process from PRIORITY QUEUE -> DB
     void run_task_scheduler() {
         separator("Running Task Scheduler");
-        while (!task_scheduler.isEmpty()) {
-            // Extract the (priority, data) pair
-            auto item = task_scheduler.extract_min();
-            int priority = item.first;
-            std::shared_ptr<Task> task = item.second; // Get the shared_ptr to the task
+        while (true) {
+            std::shared_ptr<Task> task;
+            if (window) {
+                task = window->next(); // From memory; refills happen in the background
+                if (!task) break;
+            } else {
+                if (task_scheduler.isEmpty()) break;
+                task = task_scheduler.extract_min().second;
+            }
+            int priority = task->priority;
+
+            task->started_at = std::chrono::steady_clock::now();
+            wait_times.record(TaskStage::Scheduler, priority, task->started_at - task->scheduled_at);
             
             std::cout << "\nExecuting Task (Priority " << priority << "): '" << task->title << "'" << std::endl;
             std::cout << "  -> Changing status from '" << task->status << "' to 'in_progress'" << std::endl;
@@ -126,27 +386,69 @@ public:
             std::string old_status = result.second;
             
             if (success) {
-                // We PUSH the "undo" operation onto the IN-MEMORY STACK
-                std::map<std::string, std::string> data;
-                data["task_id"] = std::to_string(task->task_id);
-                data["old_status"] = old_status;
-                
-                undo_stack.push(UndoAction("update_status", data));
-                std::cout << "[Stack]: Pushed undo action for task " << task->task_id << std::endl;
+                // Counters and the undo stack pick this up from the bus
+                events.publish(TaskEventType::Started, *task, old_status, "in_progress");
+                std::cout << "[Events]: Published start of task " << task->task_id << std::endl;
             }
 
             std::this_thread::sleep_for(std::chrono::milliseconds(500));
             
             std::cout << "  -> Task '" << task->title << "' complete." << std::endl;
-            db->updateTaskStatus(task->task_id, "completed");
+            auto done = db->updateTaskStatus(task->task_id, "completed");
+            if (done.first) {
+                events.publish(TaskEventType::Completed, *task, done.second, "completed");
+            }
+            wait_times.record(TaskStage::Execution, priority,
+                              std::chrono::steady_clock::now() - task->started_at);
         }
         // When task shared_ptrs go out of scope, the memory is freed.
         std::cout << "Task Scheduler is empty. All high-priority work is done." << std::endl;
+
+        events.flush();
+        if (history) history->flush(); // Write the last partial batch
+        events.report();
+        std::cout << "  slowest event took " << max_event_latency_us.load() << " us to pass every subscriber" << std::endl;
+
+        wait_times.report();
+        wait_times.check_starvation();
+    }
+
+    // Correct the in-memory counts against a GROUP BY on the DB.
+    // Run at startup and periodically to absorb outside changes.
+    void reconcile_counters() {
+        counters.reconcile(db->getTaskCounts());
+    }
+
+    // O(1) status summary, no GROUP BY needed
+    void show_task_counts() {
+        separator("Task Counts");
+        events.flush();
+        counters.report();
+    }
+
+    // Recent versions of a task, and its state just before the last change
+    void show_task_history(int task_id) {
+        separator("Task History");
+        if (!history) {
+            std::cout << "Task history is not being recorded." << std::endl;
+            return;
+        }
+        events.flush();
+        std::vector<TaskVersion> versions = history->recent(task_id);
+        std::cout << "[History]: Task " << task_id << " has " << versions.size() << " recent versions" << std::endl;
+        for (const TaskVersion& v : versions) {
+            std::cout << "  at " << v.changed_at_us << " us: '" << v.status << "', priority " << v.priority << std::endl;
+        }
+        TaskVersion before;
+        if (!versions.empty() && history->stateAt(task_id, versions.back().changed_at_us - 1, before)) {
+            std::cout << "[History]: Just before its last change it was '" << before.status << "'" << std::endl;
+        }
     }
 
     // Step 5: Demonstrate IN-MEMORY STACK
     void undo_last_action() {
         separator("Undo Last Action");
+        events.flush(); // The undo subscriber may still be pushing
         if (undo_stack.isEmpty()) {
             std::cout << "Nothing to undo." << std::endl;
             return;
@@ -160,19 +462,131 @@ public:
             
             std::cout << "Undoing status update for Task ID " << task_id << "..." << std::endl;
             std::cout << "  -> Reverting to status: '" << status_to_revert << "'" << std::endl;
-            db->updateTaskStatus(task_id, status_to_revert);
+            auto result = db->updateTaskStatus(task_id, status_to_revert);
+            if (result.first) {
+                Task reverted;
+                reverted.task_id = task_id;
+                reverted.priority = std::stoi(action.data["priority"]);
+                reverted.assignee_id = std::stoi(action.data["assignee_id"]);
+                events.publish(TaskEventType::Reverted, reverted, result.second, status_to_revert);
+            }
         }
     }
 };
 
+/*
+ * `task_manager export <file>`: stream the Tasks table into a
+ * columnar analytics file (see storage/ColumnarFile.h).
+ */
+int export_tasks(DatabaseConnector& db, const std::string& path) {
+    separator("Columnar Export");
+    ColumnarWriter writer(path);
+    if (!writer.open()) {
+        return 1;
+    }
+    bool ok = db.streamTasks(10000, [&writer](const std::vector<Task>& batch) {
+        for (const Task& t : batch) {
+            writer.append(t);
+        }
+    });
+    if (!writer.close() || !ok) {
+        return 1;
+    }
+    std::cout << "[Export]: Wrote " << writer.rows_written() << " tasks to " << path << std::endl;
+    return 0;
+}
+
+/*
+ * `task_manager scan <file> <column>`: print one column of an export,
+ * reading only that column's data.
+ */
+int scan_export(const std::string& path, const std::string& column) {
+    ColumnarReader reader(path);
+    if (!reader.open()) {
+        return 1;
+    }
+    // Look the column up first: the scans also return false on a corrupt chunk
+    auto col = std::find_if(reader.columns().begin(), reader.columns().end(),
+                            [&column](const ColumnarFile::Column& c) { return c.name == column; });
+    if (col == reader.columns().end()) {
+        std::cerr << "[Columnar]: No column '" << column << "' in " << path << std::endl;
+        return 1;
+    }
+    bool ok = col->type == ColumnarFile::Type::String
+                  ? reader.scan_string(column, [](const std::string& v) { std::cout << v << "\n"; })
+                  : reader.scan_int(column, [](std::int64_t v) { std::cout << v << "\n"; });
+    if (!ok) {
+        std::cerr << "[Columnar]: Corrupt data in column '" << column << "' of " << path << std::endl;
+        return 1;
+    }
+    std::cerr << "[Columnar]: Read " << reader.bytes_read() << " bytes for " << reader.row_count() << " rows" << std::endl;
+    return 0;
+}
+
 // --- Main Execution ---
-int main() {
+int main(int argc, char** argv) {
+    std::string command = argc > 1 ? argv[1] : "";
+    if (command == "scan" && argc > 3) {
+        return scan_export(argv[2], argv[3]);
+    }
+
     std::cout << "Starting BuildWithData C++ Project..." << std::endl;
     
     DatabaseConnector db(DB_HOST, DB_USER, DB_PASS, DB_NAME);
     db.connect();
+
+    if (command == "export" && argc > 2) {
+        // A full-table scan is exactly the load to keep off the primary.
+        // (The scheduler's own reads stay there, see DatabaseConnector.h.)
+        for (const std::string& replica : DB_READ_REPLICAS) {
+            db.addReadReplica(replica, REPLICA_MAX_LAG_SECONDS);
+        }
+        int rc = export_tasks(db, argv[2]);
+        db.disconnect();
+        return rc;
+    }
+
+    // Secondary indexes kept in sync by every write through `db`
+    TaskCache cache;
+    db.setCache(&cache);
+
+    // Task versions are written in batches on a connection of their own.
+    // Declared before the manager, so they outlive its event threads.
+    DatabaseConnector history_db(DB_HOST, DB_USER, DB_PASS, DB_NAME);
+    history_db.connect();
+    TaskHistory history(&history_db);
     
     TaskManager manager(&db);
+    manager.attach_history(&history);
+    manager.reconcile_counters(); // Start from the DB's current counts
+
+    // Recover anything submitted but not persisted before a crash
+    WriteAheadLog wal(WAL_DIR);
+    std::vector<std::unique_ptr<Task>> recovered;
+    if (wal.open(recovered)) {
+        manager.attach_wal(&wal, recovered);
+    }
+
+    // Other local services can push tasks over the Unix socket
+    IngestServer ingest(INGEST_SOCKET_PATH, INGEST_THREADS,
+                        [&manager](std::vector<std::unique_ptr<Task>>& batch) {
+                            return manager.submit_tasks(batch);
+                        });
+    ingest.start();
+
+    // Windowed mode refills on its own connection, off the executor's thread
+    DatabaseConnector refill_db(DB_HOST, DB_USER, DB_PASS, DB_NAME);
+    std::unique_ptr<SchedulerWindow> window;
+    if (SCHEDULER_WINDOW_SIZE > 0) {
+        refill_db.connect();
+        refill_db.setCache(&cache);
+        window.reset(new SchedulerWindow(&refill_db, SCHEDULER_WINDOW_SIZE, SCHEDULER_LOW_WATERMARK));
+        manager.attach_window(window.get());
+    }
+
+    // Co-located producers can also write straight into shared memory
+    std::unique_ptr<ShmSubmissionRing> ring = ShmSubmissionRing::create(SHM_RING_NAME, SHM_RING_CAPACITY);
+    manager.attach_submission_ring(ring.get());
     
     // 1. Simulate user input -> In-Memory Queue
     manager.submit_new_task("Fix login bug (C++)", "Login page crashes", 1, 1);
@@ -186,13 +600,38 @@ int main() {
     
     // 3. Load from DB -> In-Memory Priority Queue
     manager.load_tasks_into_scheduler();
+    manager.show_scheduler_snapshot();
     
     // 4. Process tasks from Priority Queue -> DB
     manager.run_task_scheduler();
     
     // 5. Demonstrate Stack -> Undo last action
     manager.undo_last_action();
+    manager.show_task_counts();
+
+    // 6. Answer index queries from memory, no DB round trip
+    separator("In-Memory Task Indexes");
+    std::vector<Task> user_tasks = cache.tasksByAssignee(1, "completed");
+    std::cout << "[Cache]: User 1 has " << user_tasks.size() << " completed tasks" << std::endl;
+    for (const Task& t : user_tasks) {
+        std::cout << "  " << t.toString() << std::endl;
+    }
+    std::cout << "[Cache]: " << cache.countByStatus("in_progress") << " tasks in progress" << std::endl;
+    for (const Task& t : cache.topTasksByStatus("pending", 3)) {
+        std::cout << "[Cache]: Next pending: " << t.toString() << std::endl;
+    }
+    for (const Task& t : cache.searchTasks("login OR deploy*")) {
+        std::cout << "[Search]: 'login OR deploy*' matched " << t.toString() << std::endl;
+    }
+
+    // 7. Every version of a task, and what it looked like in the past
+    if (!user_tasks.empty()) {
+        manager.show_task_history(user_tasks.front().task_id);
+    }
     
+    ingest.stop();
+    if (window) window->stop();
+    refill_db.disconnect();
     db.disconnect();
     std::cout << "BuildWithData C++ Project finished." << std::endl;
     return 0;
@@ -0,0 +1,188 @@
+#include "TaskCounters.h"
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <thread>
+
+static const char* STATUS_NAMES[TaskCounters::NUM_STATUSES] = {"pending", "in_progress", "completed"};
+
+TaskCounters::TaskCounters() {
+    for (Shard& shard : shards) {
+        for (auto& row : shard.cells) {
+            for (auto& cell : row) {
+                cell.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+}
+
+int TaskCounters::status_index(const std::string& status) {
+    for (int i = 0; i < NUM_STATUSES; i++) {
+        if (status == STATUS_NAMES[i]) return i;
+    }
+    return -1;
+}
+
+int TaskCounters::clamp_priority(int priority) {
+    if (priority < MIN_PRIORITY) return MIN_PRIORITY;
+    if (priority > MAX_PRIORITY) return MAX_PRIORITY;
+    return priority;
+}
+
+TaskCounters::Shard& TaskCounters::local_shard() {
+    // Hash the thread id once per thread
+    thread_local const std::size_t slot = std::hash<std::thread::id>()(std::this_thread::get_id()) % NUM_SHARDS;
+    return shards[slot];
+}
+
+void TaskCounters::add(Shard& shard, int status, int priority, int assignee_id, std::int64_t delta) {
+    if (status < 0) {
+        return; // Unknown status string; reconcile() will report it
+    }
+    shard.cells[status][clamp_priority(priority) - MIN_PRIORITY].fetch_add(delta, std::memory_order_relaxed);
+
+    std::lock_guard<std::mutex> lock(shard.assignee_mutex);
+    shard.by_assignee[assignee_id][status] += delta; // New entries start zeroed
+}
+
+void TaskCounters::on_created(const std::string& status, int priority, int assignee_id) {
+    add(local_shard(), status_index(status), priority, assignee_id, 1);
+}
+
+void TaskCounters::on_status_changed(const std::string& old_status, const std::string& new_status,
+                                     int priority, int assignee_id) {
+    if (old_status == new_status) {
+        return;
+    }
+    Shard& shard = local_shard();
+    add(shard, status_index(old_status), priority, assignee_id, -1);
+    add(shard, status_index(new_status), priority, assignee_id, 1);
+}
+
+// --- Reads ---
+
+std::int64_t TaskCounters::count(const std::string& status) const {
+    int s = status_index(status);
+    if (s < 0) return 0;
+    std::int64_t total = 0;
+    for (const Shard& shard : shards) {
+        for (const auto& cell : shard.cells[s]) {
+            total += cell.load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+std::int64_t TaskCounters::count(const std::string& status, int priority) const {
+    int s = status_index(status);
+    if (s < 0) return 0;
+    std::int64_t total = 0;
+    for (const Shard& shard : shards) {
+        total += shard.cells[s][clamp_priority(priority) - MIN_PRIORITY].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+std::int64_t TaskCounters::count_for_assignee(int assignee_id, const std::string& status) const {
+    int s = status_index(status);
+    if (s < 0) return 0;
+    std::int64_t total = 0;
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.assignee_mutex);
+        auto it = shard.by_assignee.find(assignee_id);
+        if (it != shard.by_assignee.end()) {
+            total += it->second[s];
+        }
+    }
+    return total;
+}
+
+std::unordered_map<int, TaskCounters::StatusCounts> TaskCounters::merged_assignees() const {
+    std::unordered_map<int, StatusCounts> merged;
+    for (const Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.assignee_mutex);
+        for (const auto& entry : shard.by_assignee) {
+            StatusCounts& counts = merged[entry.first];
+            for (int s = 0; s < NUM_STATUSES; s++) {
+                counts[s] += entry.second[s];
+            }
+        }
+    }
+    return merged;
+}
+
+// --- Reconciliation ---
+
+/*
+ * For every cell, computes (database - counters) and books the
+ * difference into this thread's shard, so the merged total matches
+ * the database. Updates racing with the GROUP BY can still leave a
+ * small drift; the next reconcile catches it.
+ */
+int TaskCounters::reconcile(const std::vector<TaskCountRow>& db_counts) {
+    std::int64_t db_cells[NUM_STATUSES][MAX_PRIORITY - MIN_PRIORITY + 1] = {};
+    std::map<int, StatusCounts> db_assignees;
+    for (const TaskCountRow& row : db_counts) {
+        int s = status_index(row.status);
+        if (s < 0) {
+            std::cerr << "[Counters]: Ignoring unknown status '" << row.status << "'" << std::endl;
+            continue;
+        }
+        db_cells[s][clamp_priority(row.priority) - MIN_PRIORITY] += row.count;
+        db_assignees[row.assignee_id][s] += row.count;
+    }
+
+    Shard& shard = local_shard();
+    int corrected = 0;
+
+    for (int s = 0; s < NUM_STATUSES; s++) {
+        for (int p = MIN_PRIORITY; p <= MAX_PRIORITY; p++) {
+            std::int64_t diff = db_cells[s][p - MIN_PRIORITY] - count(STATUS_NAMES[s], p);
+            if (diff != 0) {
+                shard.cells[s][p - MIN_PRIORITY].fetch_add(diff, std::memory_order_relaxed);
+                corrected++;
+            }
+        }
+    }
+
+    // Assignees we count but the DB doesn't know must drop to zero too
+    std::unordered_map<int, StatusCounts> ours = merged_assignees();
+    for (const auto& entry : ours) {
+        db_assignees[entry.first]; // Inserts all-zero counts if missing
+    }
+    std::lock_guard<std::mutex> lock(shard.assignee_mutex);
+    for (const auto& entry : db_assignees) {
+        auto it = ours.find(entry.first);
+        for (int s = 0; s < NUM_STATUSES; s++) {
+            std::int64_t have = it == ours.end() ? 0 : it->second[s];
+            std::int64_t diff = entry.second[s] - have;
+            if (diff != 0) {
+                shard.by_assignee[entry.first][s] += diff;
+                corrected++;
+            }
+        }
+    }
+
+    if (corrected > 0) {
+        std::cout << "[Counters]: Reconciled " << corrected << " drifted counts with the database" << std::endl;
+    }
+    return corrected;
+}
+
+void TaskCounters::report() const {
+    std::cout << "[Counters]: Tasks per status and priority" << std::endl;
+    std::cout << std::left << std::setw(14) << "  status";
+    for (int p = MIN_PRIORITY; p <= MAX_PRIORITY; p++) {
+        std::cout << std::setw(6) << ("P" + std::to_string(p));
+    }
+    std::cout << "total" << std::endl;
+    for (int s = 0; s < NUM_STATUSES; s++) {
+        std::cout << "  " << std::setw(12) << STATUS_NAMES[s];
+        for (int p = MIN_PRIORITY; p <= MAX_PRIORITY; p++) {
+            std::cout << std::setw(6) << count(STATUS_NAMES[s], p);
+        }
+        std::cout << count(STATUS_NAMES[s]) << std::endl;
+    }
+    std::cout << std::right;
+}
@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// One row of `SELECT status, priority, assignee_id, COUNT(*) ... GROUP BY`
+struct TaskCountRow {
+    std::string status;
+    int priority;
+    int assignee_id; // 0 = unassigned
+    std::int64_t count;
+};
+
+/*
+ * Materialized task counts per status, per (status, priority) and per
+ * (assignee, status), so status summaries are O(1) reads instead of
+ * GROUP BY queries.
+ *
+ * TaskManager calls on_created / on_status_changed for every create
+ * and status transition. Updates go to a per-thread shard (picked
+ * once per thread) so concurrent writers don't fight over one cache
+ * line; reads add up the fixed number of shards.
+ *
+ * reconcile() compares the counters with a GROUP BY from the database
+ * and corrects any drift (e.g. tasks changed by other processes).
+ */
+class TaskCounters {
+public:
+    static const int NUM_STATUSES = 3; // pending, in_progress, completed
+    static const int MIN_PRIORITY = 1;
+    static const int MAX_PRIORITY = 5;
+    static const int NUM_SHARDS = 16;
+
+    TaskCounters();
+
+    void on_created(const std::string& status, int priority, int assignee_id);
+    void on_status_changed(const std::string& old_status, const std::string& new_status,
+                           int priority, int assignee_id);
+
+    // --- O(1) reads (sum over NUM_SHARDS) ---
+    std::int64_t count(const std::string& status) const;
+    std::int64_t count(const std::string& status, int priority) const;
+    std::int64_t count_for_assignee(int assignee_id, const std::string& status) const;
+
+    // Replaces drifted counts with the database's. Returns how many
+    // cells were corrected.
+    int reconcile(const std::vector<TaskCountRow>& db_counts);
+
+    // Prints a status x priority table
+    void report() const;
+
+private:
+    typedef std::array<std::int64_t, NUM_STATUSES> StatusCounts;
+
+    struct alignas(64) Shard {
+        // [status][priority - MIN_PRIORITY]
+        std::atomic<std::int64_t> cells[NUM_STATUSES][MAX_PRIORITY - MIN_PRIORITY + 1];
+        mutable std::mutex assignee_mutex; // Effectively uncontended: one thread per shard
+        std::unordered_map<int, StatusCounts> by_assignee;
+    };
+
+    Shard shards[NUM_SHARDS];
+
+    Shard& local_shard();
+    void add(Shard& shard, int status, int priority, int assignee_id, std::int64_t delta);
+    std::unordered_map<int, StatusCounts> merged_assignees() const;
+
+    static int status_index(const std::string& status);
+    static int clamp_priority(int priority);
+};
@@ -0,0 +1,113 @@
+#include "WaitTimeHistogram.h"
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+// --- LatencyHistogram ---
+
+LatencyHistogram::LatencyHistogram() : _count(0), _sum(0), _max(0) {
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        buckets[i] = 0;
+    }
+}
+
+void LatencyHistogram::record(std::uint64_t micros) {
+    // Bucket index is the number of significant bits in the sample
+    int bucket = 0;
+    std::uint64_t v = micros;
+    while (v > 0 && bucket < NUM_BUCKETS - 1) {
+        v >>= 1;
+        bucket++;
+    }
+    buckets[bucket]++;
+    _count++;
+    _sum += micros;
+    if (micros > _max) {
+        _max = micros;
+    }
+}
+
+std::uint64_t LatencyHistogram::percentile(double p) const {
+    if (_count == 0) {
+        return 0;
+    }
+    // Rank of the sample we are looking for (1-based, rounded up)
+    std::uint64_t rank = (std::uint64_t)std::ceil((p / 100.0) * _count);
+    if (rank == 0) rank = 1;
+
+    std::uint64_t seen = 0;
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            std::uint64_t upper = (i == 0) ? 1 : ((std::uint64_t)1 << i);
+            // Never report more than we actually observed
+            return upper < _max ? upper : _max;
+        }
+    }
+    return _max;
+}
+
+// --- WaitTimeTracker ---
+
+WaitTimeTracker::WaitTimeTracker(std::chrono::microseconds starvation_threshold)
+    : threshold(starvation_threshold) {}
+
+int WaitTimeTracker::clamp_priority(int priority) {
+    if (priority < MIN_PRIORITY) return MIN_PRIORITY;
+    if (priority > MAX_PRIORITY) return MAX_PRIORITY;
+    return priority;
+}
+
+std::string WaitTimeTracker::stage_name(TaskStage stage) {
+    switch (stage) {
+        case TaskStage::Queue: return "queue";
+        case TaskStage::Scheduler: return "scheduler";
+        case TaskStage::Execution: return "execution";
+    }
+    return "unknown";
+}
+
+void WaitTimeTracker::record(TaskStage stage, int priority, std::chrono::steady_clock::duration elapsed) {
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    if (micros < 0) micros = 0;
+    histograms[(int)stage][clamp_priority(priority) - MIN_PRIORITY].record((std::uint64_t)micros);
+}
+
+const LatencyHistogram& WaitTimeTracker::histogram(TaskStage stage, int priority) const {
+    return histograms[(int)stage][clamp_priority(priority) - MIN_PRIORITY];
+}
+
+std::vector<int> WaitTimeTracker::check_starvation() const {
+    std::vector<int> starving;
+    for (int p = MIN_PRIORITY; p <= MAX_PRIORITY; p++) {
+        // Only the waiting stages count towards starvation
+        for (TaskStage stage : {TaskStage::Queue, TaskStage::Scheduler}) {
+            std::uint64_t p99 = histogram(stage, p).percentile(99.0);
+            if (p99 > (std::uint64_t)threshold.count()) {
+                std::cerr << "[Metrics]: STARVATION ALERT - priority " << p
+                          << " p99 " << stage_name(stage) << " wait is " << p99
+                          << "us (threshold " << threshold.count() << "us)" << std::endl;
+                starving.push_back(p);
+                break;
+            }
+        }
+    }
+    return starving;
+}
+
+void WaitTimeTracker::report() const {
+    std::cout << "[Metrics]: Wait times per priority (microseconds)" << std::endl;
+    std::cout << std::left << std::setw(11) << "  stage" << std::setw(10) << "priority"
+              << std::setw(8) << "count" << std::setw(12) << "p50"
+              << std::setw(12) << "p99" << "max" << std::endl;
+    for (int s = 0; s < NUM_STAGES; s++) {
+        for (int p = MIN_PRIORITY; p <= MAX_PRIORITY; p++) {
+            const LatencyHistogram& h = histogram((TaskStage)s, p);
+            if (h.count() == 0) continue;
+            std::cout << "  " << std::setw(9) << stage_name((TaskStage)s) << std::setw(10) << p
+                      << std::setw(8) << h.count() << std::setw(12) << h.percentile(50.0)
+                      << std::setw(12) << h.percentile(99.0) << h.max() << std::endl;
+        }
+    }
+    std::cout << std::right;
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * A log-scale latency histogram.
+ *
+ * Bucket i counts samples in [2^(i-1), 2^i) microseconds (bucket 0
+ * holds samples under 1us). This keeps memory fixed no matter how
+ * many samples we record, at the cost of percentiles being
+ * "rounded up" to the next power of two.
+ */
+class LatencyHistogram {
+public:
+    static const int NUM_BUCKETS = 40; // 2^39 us is ~6 days
+
+    LatencyHistogram();
+
+    // Complexity: O(1)
+    void record(std::uint64_t micros);
+
+    // Upper bound of the bucket holding the p-th percentile (0..100).
+    // Complexity: O(NUM_BUCKETS)
+    std::uint64_t percentile(double p) const;
+
+    std::uint64_t count() const { return _count; }
+    std::uint64_t max() const { return _max; }
+    double mean() const { return _count == 0 ? 0.0 : (double)_sum / _count; }
+
+private:
+    std::uint64_t buckets[NUM_BUCKETS];
+    std::uint64_t _count;
+    std::uint64_t _sum;
+    std::uint64_t _max;
+};
+
+// The stages a task passes through in TaskManager.
+enum class TaskStage {
+    Queue = 0,     // Waiting in new_task_queue
+    Scheduler = 1, // Waiting in task_scheduler
+    Execution = 2  // Running in run_task_scheduler
+};
+
+/*
+ * Aggregates per-stage, per-priority latency histograms and raises
+ * starvation alerts when the p99 wait (Queue or Scheduler stage) of
+ * any priority level exceeds the configured threshold.
+ */
+class WaitTimeTracker {
+public:
+    static const int MIN_PRIORITY = 1;
+    static const int MAX_PRIORITY = 5;
+    static const int NUM_STAGES = 3;
+
+    explicit WaitTimeTracker(std::chrono::microseconds starvation_threshold);
+
+    // Out-of-range priorities are clamped into [MIN_PRIORITY, MAX_PRIORITY].
+    void record(TaskStage stage, int priority, std::chrono::steady_clock::duration elapsed);
+
+    const LatencyHistogram& histogram(TaskStage stage, int priority) const;
+
+    // Prints an alert for every starving priority and returns them.
+    std::vector<int> check_starvation() const;
+
+    // Prints a p50/p99/max table for every stage and priority.
+    void report() const;
+
+private:
+    LatencyHistogram histograms[NUM_STAGES][MAX_PRIORITY - MIN_PRIORITY + 1];
+    std::chrono::microseconds threshold;
+
+    static int clamp_priority(int priority);
+    static std::string stage_name(TaskStage stage);
+};
@@ -1,6 +1,8 @@
 #pragma once
 #include <string>
 #include <sstream>
+#include <chrono> // For wait-time timestamps
+#include <cstdint>
 
 class Task {
 public:
@@ -10,6 +12,16 @@ public:
     std::string description;
     std::string status;
     int priority; // 1 = High, 5 = Low
+    std::int64_t created_at = 0; // Unix seconds; only set by queries that select it
+
+    // In-memory lifecycle timestamps (not persisted).
+    // Used to measure how long a task waits at each stage.
+    std::chrono::steady_clock::time_point enqueued_at;  // Entered new_task_queue
+    std::chrono::steady_clock::time_point scheduled_at; // Entered task_scheduler
+    std::chrono::steady_clock::time_point started_at;   // Began executing
+
+    // Log sequence number in the local write-ahead log (0 = not logged)
+    std::uint64_t wal_lsn = 0;
 
     // Default constructor
     Task() : task_id(0), assignee_id(0), priority(3), status("pending") {}
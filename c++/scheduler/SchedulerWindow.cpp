@@ -0,0 +1,168 @@
+#include "SchedulerWindow.h"
+#include <ctime>
+#include <iostream>
+#include <vector>
+
+SchedulerWindow::SchedulerWindow(DatabaseConnector* refill_db, std::size_t cap, std::size_t low)
+    : db(refill_db), capacity(cap < 1 ? 1 : cap), low_watermark(low < cap ? low : cap / 2),
+      epoch(0), refill_requested(false), backlog_drained(false), running(false), refill_count(0) {}
+
+SchedulerWindow::~SchedulerWindow() {
+    stop();
+}
+
+void SchedulerWindow::start() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (running) {
+        return;
+    }
+    running = true;
+    refill_thread = std::thread(&SchedulerWindow::refill_loop, this);
+    request_refill_locked();
+    std::cout << "[Window]: Holding up to " << capacity << " tasks, refilling below " << low_watermark << std::endl;
+}
+
+void SchedulerWindow::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    refill_cv.notify_all();
+    ready_cv.notify_all();
+    if (refill_thread.joinable()) {
+        refill_thread.join();
+    }
+}
+
+SchedulerWindow::Key SchedulerWindow::key_of(const Task& task) {
+    return Key(task.priority, task.created_at, task.task_id);
+}
+
+void SchedulerWindow::add_locked(std::shared_ptr<Task> task) {
+    task->scheduled_at = std::chrono::steady_clock::now();
+    ids_in_window.insert(task->task_id);
+    Key key = key_of(*task);
+    window.insert(std::move(task), key);
+}
+
+void SchedulerWindow::request_refill_locked() {
+    if (!refill_requested) {
+        refill_requested = true;
+        refill_cv.notify_one();
+    }
+}
+
+std::shared_ptr<Task> SchedulerWindow::next() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (window.isEmpty()) {
+        if (!running || (backlog_drained && !refill_requested)) {
+            return nullptr;
+        }
+        request_refill_locked();
+        ready_cv.wait(lock);
+    }
+
+    std::shared_ptr<Task> task = window.extract_min().second;
+    ids_in_window.erase(task->task_id);
+    // Refill early so the executor never finds the window empty
+    if ((std::size_t)window.size() < low_watermark && !backlog_drained) {
+        request_refill_locked();
+    }
+    return task;
+}
+
+void SchedulerWindow::offer(const Task& task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    backlog_drained = false; // There is at least one more pending task
+
+    if (task.priority >= cursor.priority) {
+        // Sorts after the cursor (same priority: newer created_at and
+        // task_id), so a refill will fetch it
+        if ((std::size_t)window.size() < low_watermark) {
+            request_refill_locked();
+        }
+        return;
+    }
+
+    std::shared_ptr<Task> copy = std::make_shared<Task>(task);
+    if (copy->created_at == 0) {
+        copy->created_at = (std::int64_t)std::time(nullptr); // Just inserted; close to the DB's NOW()
+    }
+    add_locked(std::move(copy));
+
+    if ((std::size_t)window.size() > capacity) {
+        // Over budget: drop the least urgent task and rewind the cursor
+        // to the largest key still held, so it is fetched again later
+        std::shared_ptr<Task> shed = window.extract_max().second;
+        ids_in_window.erase(shed->task_id);
+        Key last = window.peek_max().first;
+        cursor.priority = std::get<0>(last);
+        cursor.created_at = std::get<1>(last);
+        cursor.task_id = std::get<2>(last);
+        epoch++;
+        backlog_drained = false;
+    }
+    ready_cv.notify_all();
+}
+
+std::size_t SchedulerWindow::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return (std::size_t)window.size();
+}
+
+std::uint64_t SchedulerWindow::refills() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return refill_count;
+}
+
+/*
+ * Runs the DB query with the lock released, so next() and offer()
+ * never wait on MySQL. If offer() rewound the cursor meanwhile, the
+ * page may overlap what will be fetched from the new cursor, so it
+ * is thrown away and fetched again.
+ */
+void SchedulerWindow::refill_loop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        refill_cv.wait(lock, [this] { return refill_requested || !running; });
+        if (!running) {
+            break;
+        }
+
+        std::size_t held = (std::size_t)window.size();
+        std::size_t want = capacity > held ? capacity - held : 0;
+        if (want == 0) {
+            refill_requested = false;
+            ready_cv.notify_all();
+            continue;
+        }
+        PendingCursor from = cursor;
+        std::uint64_t at_epoch = epoch;
+
+        lock.unlock();
+        std::vector<Task*> rows = db->getPendingTasksAfter(from, (int)want);
+        lock.lock();
+        refill_count++;
+
+        if (epoch != at_epoch) {
+            for (Task* t : rows) delete t;
+            continue; // Still requested; fetch again from the rewound cursor
+        }
+
+        if (!rows.empty()) {
+            cursor.priority = rows.back()->priority;
+            cursor.created_at = rows.back()->created_at;
+            cursor.task_id = rows.back()->task_id;
+        }
+        for (Task* t : rows) {
+            if (ids_in_window.count(t->task_id)) {
+                delete t;
+                continue;
+            }
+            add_locked(std::shared_ptr<Task>(t));
+        }
+        backlog_drained = rows.size() < want;
+        refill_requested = false;
+        ready_cv.notify_all();
+    }
+}
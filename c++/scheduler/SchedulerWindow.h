@@ -0,0 +1,84 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_set>
+#include "../models/Task.h"
+#include "../db/DatabaseConnector.h"
+#include "../data_structures/MinMaxHeap.h"
+
+/*
+ * Windowed scheduler: keeps only the next `capacity` pending tasks
+ * in memory instead of the whole backlog.
+ *
+ * Tasks are fetched in (priority, created_at, task_id) order with a
+ * keyset cursor (DatabaseConnector::getPendingTasksAfter). When the
+ * window drops below `low_watermark`, a background thread fetches
+ * the next page on its OWN connection, so the executor keeps taking
+ * tasks from memory while the refill runs. Memory is bounded by
+ * `capacity` no matter how large the backlog is.
+ *
+ * New tasks: the cursor only moves forward, so a task created with a
+ * higher priority than the cursor would never be fetched. Such tasks
+ * must be offer()ed; they go straight into the window (evicting the
+ * least urgent entry if full, after which the cursor is rewound so
+ * the evicted task is fetched again later). Anything at or after the
+ * cursor's priority is picked up by a later refill.
+ *
+ * Thread-safe: next() and offer() may be called from any thread.
+ */
+class SchedulerWindow {
+public:
+    // `refill_db` must be connected and is used only by the refill thread
+    SchedulerWindow(DatabaseConnector* refill_db, std::size_t capacity, std::size_t low_watermark);
+    ~SchedulerWindow();
+
+    SchedulerWindow(const SchedulerWindow&) = delete;
+    SchedulerWindow& operator=(const SchedulerWindow&) = delete;
+
+    // Starts the refill thread and requests the first page
+    void start();
+
+    // Stops and joins the refill thread. Safe to call more than once.
+    void stop();
+
+    // Next task to run. Returns immediately while the window has tasks;
+    // only waits when it is empty and a refill is in flight. Returns
+    // nullptr once the window and the pending backlog are both empty.
+    std::shared_ptr<Task> next();
+
+    // Tell the window about a task just created in the DB
+    void offer(const Task& task);
+
+    std::size_t size() const;
+    std::uint64_t refills() const;
+
+private:
+    using Key = std::tuple<int, std::int64_t, int>; // (priority, created_at, task_id)
+
+    DatabaseConnector* db;
+    std::size_t capacity;
+    std::size_t low_watermark;
+
+    mutable std::mutex mutex; // Guards everything below
+    std::condition_variable refill_cv; // Wakes the refill thread
+    std::condition_variable ready_cv;  // Wakes next() after a refill
+    MinMaxHeap<std::shared_ptr<Task>, Key> window;
+    std::unordered_set<int> ids_in_window; // Guards against fetching a task twice
+    PendingCursor cursor;   // Last key fetched from the DB
+    std::uint64_t epoch;    // Bumped when the cursor is rewound
+    bool refill_requested;
+    bool backlog_drained;   // Last refill returned fewer rows than asked
+    bool running;
+    std::uint64_t refill_count;
+    std::thread refill_thread;
+
+    static Key key_of(const Task& task);
+    void add_locked(std::shared_ptr<Task> task);
+    void request_refill_locked();
+    void refill_loop();
+};
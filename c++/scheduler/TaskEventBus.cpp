@@ -0,0 +1,115 @@
+#include "TaskEventBus.h"
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+static void copy_status(char (&dst)[16], const std::string& src) {
+    std::size_t n = src.size() < sizeof(dst) - 1 ? src.size() : sizeof(dst) - 1;
+    std::memcpy(dst, src.data(), n);
+    dst[n] = '\0';
+}
+
+TaskEventBus::TaskEventBus(std::size_t capacity) : ring(capacity), running(false), started(false) {}
+
+TaskEventBus::~TaskEventBus() {
+    stop();
+}
+
+int TaskEventBus::subscribe(const std::string& name, Handler handler, const std::vector<int>& after) {
+    if (started) {
+        throw std::runtime_error("TaskEventBus: subscribe '" + name + "' before start()");
+    }
+    std::vector<const Disruptor<TaskEvent>::Consumer*> upstream;
+    for (int id : after) {
+        upstream.push_back(subscribers.at(id)->consumer);
+    }
+    std::unique_ptr<Subscriber> sub(new Subscriber());
+    sub->name = name;
+    sub->handler = std::move(handler);
+    sub->consumer = ring.add_consumer(upstream);
+    subscribers.push_back(std::move(sub));
+    return (int)subscribers.size() - 1;
+}
+
+void TaskEventBus::start() {
+    if (started) {
+        return;
+    }
+    started = true;
+    running.store(true, std::memory_order_release);
+    for (auto& sub : subscribers) {
+        sub->thread = std::thread(&TaskEventBus::consume, this, std::ref(*sub));
+    }
+}
+
+void TaskEventBus::stop() {
+    running.store(false, std::memory_order_release);
+    for (auto& sub : subscribers) {
+        if (sub->thread.joinable()) {
+            sub->thread.join();
+        }
+    }
+}
+
+void TaskEventBus::publish(TaskEventType type, const Task& task, const std::string& old_status,
+                           const std::string& new_status) {
+    ring.publish([&](TaskEvent& e) {
+        e.type = type;
+        e.task_id = task.task_id;
+        e.priority = task.priority;
+        e.assignee_id = task.assignee_id;
+        copy_status(e.old_status, old_status);
+        copy_status(e.new_status, new_status);
+        e.published_at = std::chrono::steady_clock::now();
+        e.changed_at_us = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    });
+}
+
+void TaskEventBus::flush() {
+    std::int64_t target = ring.published();
+    for (auto& sub : subscribers) {
+        while (sub->consumer->position() < target) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TaskEventBus::consume(Subscriber& sub) {
+    int idle = 0;
+    auto handle = [&](const TaskEvent& e, std::int64_t, bool end_of_batch) {
+        sub.handler(e, end_of_batch);
+    };
+    while (true) {
+        std::size_t n = ring.poll(*sub.consumer, handle);
+        if (n > 0) {
+            sub.events.fetch_add(n, std::memory_order_relaxed);
+            sub.batches.fetch_add(1, std::memory_order_relaxed);
+            idle = 0;
+            continue;
+        }
+        // Upstream subscribers keep going after stop(), so only quit
+        // once this one has caught up with the last published event
+        if (!running.load(std::memory_order_acquire) && sub.consumer->position() >= ring.published()) {
+            break;
+        }
+        // Back off: spin, then yield, then sleep so an idle bus costs no CPU
+        idle++;
+        if (idle < 100) {
+            continue;
+        } else if (idle < 200) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+void TaskEventBus::report() const {
+    std::cout << "[Events]: " << ring.published() + 1 << " published (ring of " << ring.capacity() << ")" << std::endl;
+    for (const auto& sub : subscribers) {
+        std::uint64_t events = sub->events.load(std::memory_order_relaxed);
+        std::uint64_t batches = sub->batches.load(std::memory_order_relaxed);
+        std::cout << "  " << sub->name << ": " << events << " events in " << batches << " batches" << std::endl;
+    }
+}
@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../models/Task.h"
+#include "../data_structures/Disruptor.h"
+
+enum class TaskEventType { Created, Started, Completed, Reverted };
+
+/*
+ * One task transition. Plain data with fixed-size status fields, so
+ * the bus can overwrite ring slots without allocating.
+ */
+struct TaskEvent {
+    TaskEventType type = TaskEventType::Started;
+    int task_id = 0;
+    int priority = 0;
+    int assignee_id = 0;
+    char old_status[16] = {};
+    char new_status[16] = {};
+    std::chrono::steady_clock::time_point published_at;
+    std::int64_t changed_at_us = 0; // Wall clock, Unix microseconds
+};
+
+/*
+ * In-process bus for task lifecycle events, built on Disruptor.
+ *
+ * The task manager publishes each transition once; every subscriber
+ * (counters, undo log, tracing, ...) gets its own thread and sees
+ * every event in order, in batches, without locks. A subscriber can
+ * be placed `after` others, and then only sees an event once they
+ * are done with it.
+ *
+ * publish() must be called from one thread (the task manager's). It
+ * only blocks if the slowest subscriber falls a whole ring behind.
+ * Idle subscribers back off from spinning to yielding to short
+ * sleeps.
+ *
+ * Usage: subscribe() everything, start(), publish(), and flush()
+ * before reading state the subscribers maintain.
+ */
+class TaskEventBus {
+public:
+    using Handler = std::function<void(const TaskEvent& event, bool end_of_batch)>;
+
+    explicit TaskEventBus(std::size_t capacity = 4096);
+    ~TaskEventBus();
+
+    TaskEventBus(const TaskEventBus&) = delete;
+    TaskEventBus& operator=(const TaskEventBus&) = delete;
+
+    // Returns the subscriber's id, for use in a later `after` list.
+    // Only before start().
+    int subscribe(const std::string& name, Handler handler, const std::vector<int>& after = {});
+
+    void start();
+
+    // Handlers finish everything already published, then their threads exit
+    void stop();
+
+    // Producer side. `old_status` is empty for Created.
+    // Complexity: O(1), allocation-free
+    void publish(TaskEventType type, const Task& task, const std::string& old_status,
+                 const std::string& new_status);
+
+    // Wait until every subscriber has handled everything published so far
+    void flush();
+
+    // Per-subscriber event and batch counts
+    void report() const;
+
+private:
+    struct Subscriber {
+        std::string name;
+        Handler handler;
+        Disruptor<TaskEvent>::Consumer* consumer;
+        std::thread thread;
+        std::atomic<std::uint64_t> events{0};
+        std::atomic<std::uint64_t> batches{0};
+    };
+
+    Disruptor<TaskEvent> ring;
+    std::vector<std::unique_ptr<Subscriber>> subscribers;
+    std::atomic<bool> running;
+    bool started;
+
+    void consume(Subscriber& sub);
+};
@@ -0,0 +1,374 @@
+#include "ColumnarFile.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+const char ColumnarFile::MAGIC[8] = {'B', 'W', 'D', 'C', 'O', 'L', '0', '1'};
+
+// --- Encoding helpers ---
+
+static std::uint64_t zigzag(std::int64_t v) {
+    return ((std::uint64_t)v << 1) ^ (std::uint64_t)(v >> 63);
+}
+
+static std::int64_t unzigzag(std::uint64_t v) {
+    return (std::int64_t)(v >> 1) ^ -(std::int64_t)(v & 1);
+}
+
+static void put_varint(std::string& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back((char)(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back((char)v);
+}
+
+// Returns false if the buffer ends mid-varint
+static bool get_varint(const char*& p, const char* end, std::uint64_t& v) {
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        unsigned char b = (unsigned char)*p++;
+        v |= (std::uint64_t)(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static void put_string(std::string& out, const std::string& s) {
+    put_varint(out, s.size());
+    out.append(s);
+}
+
+static bool get_string(const char*& p, const char* end, std::string& s) {
+    std::uint64_t len;
+    if (!get_varint(p, end, len) || (std::uint64_t)(end - p) < len) return false;
+    s.assign(p, (std::size_t)len);
+    p += len;
+    return true;
+}
+
+// --- ColumnarFile ---
+
+std::vector<ColumnarFile::Column> ColumnarFile::task_schema() {
+    return {
+        {"task_id", Type::Int64, Encoding::Delta},
+        {"assignee_id", Type::Int64, Encoding::Plain},
+        {"priority", Type::Int64, Encoding::Plain},
+        {"status", Type::String, Encoding::Dictionary},
+        {"title", Type::String, Encoding::Plain},
+        {"description", Type::String, Encoding::Plain},
+        {"created_at", Type::Int64, Encoding::Delta},
+    };
+}
+
+// --- ColumnarWriter ---
+
+ColumnarWriter::ColumnarWriter(std::string p, std::size_t rows, bool stats)
+    : path(p), rows_per_block(rows == 0 ? 1 : rows), write_stats(stats),
+      schema(ColumnarFile::task_schema()), total_rows(0),
+      int_values(schema.size()), string_values(schema.size()) {}
+
+bool ColumnarWriter::open() {
+    out.open(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "[Export]: Cannot create " << path << std::endl;
+        return false;
+    }
+    out.write(ColumnarFile::MAGIC, sizeof(ColumnarFile::MAGIC));
+    return true;
+}
+
+void ColumnarWriter::append(const Task& task) {
+    const std::int64_t ints[] = {task.task_id, task.assignee_id, task.priority, 0, 0, 0, task.created_at};
+    const std::string* strings[] = {nullptr, nullptr, nullptr, &task.status, &task.title, &task.description, nullptr};
+    for (std::size_t c = 0; c < schema.size(); c++) {
+        if (schema[c].type == ColumnarFile::Type::Int64) {
+            int_values[c].push_back(ints[c]);
+        } else {
+            string_values[c].push_back(*strings[c]);
+        }
+    }
+    total_rows++;
+    if (int_values[0].size() >= rows_per_block) {
+        flush_block();
+    }
+}
+
+void ColumnarWriter::flush_block() {
+    std::size_t rows = int_values[0].size();
+    if (rows == 0) {
+        return;
+    }
+
+    ColumnarFile::Block block;
+    block.rows = rows;
+    std::string buf;
+
+    for (std::size_t c = 0; c < schema.size(); c++) {
+        const ColumnarFile::Column& col = schema[c];
+        ColumnarFile::Chunk chunk;
+        chunk.offset = (std::uint64_t)out.tellp();
+        chunk.has_stats = false;
+        chunk.min = chunk.max = 0;
+        buf.clear();
+
+        if (col.type == ColumnarFile::Type::Int64) {
+            const std::vector<std::int64_t>& values = int_values[c];
+            std::int64_t prev = 0;
+            for (std::int64_t v : values) {
+                put_varint(buf, zigzag(col.encoding == ColumnarFile::Encoding::Delta ? v - prev : v));
+                prev = v;
+            }
+            if (write_stats) {
+                auto mm = std::minmax_element(values.begin(), values.end());
+                chunk.has_stats = true;
+                chunk.min = *mm.first;
+                chunk.max = *mm.second;
+            }
+        } else if (col.encoding == ColumnarFile::Encoding::Dictionary) {
+            std::vector<std::string> dict;
+            std::unordered_map<std::string, std::uint64_t> codes;
+            std::string code_bytes;
+            for (const std::string& v : string_values[c]) {
+                auto it = codes.find(v);
+                if (it == codes.end()) {
+                    it = codes.emplace(v, dict.size()).first;
+                    dict.push_back(v);
+                }
+                put_varint(code_bytes, it->second);
+            }
+            put_varint(buf, dict.size());
+            for (const std::string& d : dict) {
+                put_string(buf, d);
+            }
+            buf.append(code_bytes);
+        } else {
+            for (const std::string& v : string_values[c]) {
+                put_string(buf, v);
+            }
+        }
+
+        out.write(buf.data(), (std::streamsize)buf.size());
+        chunk.length = buf.size();
+        block.chunks.push_back(chunk);
+        int_values[c].clear();
+        string_values[c].clear();
+    }
+    blocks.push_back(block);
+}
+
+bool ColumnarWriter::close() {
+    if (!out.is_open()) {
+        return false;
+    }
+    flush_block();
+
+    std::string footer;
+    put_varint(footer, schema.size());
+    for (const ColumnarFile::Column& col : schema) {
+        footer.push_back((char)col.type);
+        footer.push_back((char)col.encoding);
+        put_string(footer, col.name);
+    }
+    put_varint(footer, blocks.size());
+    for (const ColumnarFile::Block& block : blocks) {
+        put_varint(footer, block.rows);
+        for (const ColumnarFile::Chunk& chunk : block.chunks) {
+            put_varint(footer, chunk.offset);
+            put_varint(footer, chunk.length);
+            footer.push_back(chunk.has_stats ? 1 : 0);
+            put_varint(footer, zigzag(chunk.min));
+            put_varint(footer, zigzag(chunk.max));
+        }
+    }
+
+    std::uint64_t footer_offset = (std::uint64_t)out.tellp();
+    out.write(footer.data(), (std::streamsize)footer.size());
+    char tail[8];
+    for (int i = 0; i < 8; i++) {
+        tail[i] = (char)((footer_offset >> (8 * i)) & 0xFF);
+    }
+    out.write(tail, sizeof(tail));
+    out.write(ColumnarFile::MAGIC, sizeof(ColumnarFile::MAGIC));
+    out.close();
+
+    if (!out) {
+        std::cerr << "[Export]: Failed writing " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// --- ColumnarReader ---
+
+ColumnarReader::ColumnarReader(std::string p) : path(p), _bytes_read(0) {}
+
+bool ColumnarReader::open() {
+    in.open(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "[Columnar]: Cannot open " << path << std::endl;
+        return false;
+    }
+
+    char head[8];
+    char tail[16];
+    in.seekg(0, std::ios::end);
+    std::streamoff size = in.tellg();
+    if (size < 24) {
+        std::cerr << "[Columnar]: " << path << " is too small" << std::endl;
+        return false;
+    }
+    in.seekg(0);
+    in.read(head, sizeof(head));
+    in.seekg(size - 16);
+    in.read(tail, sizeof(tail));
+    if (!in || std::memcmp(head, ColumnarFile::MAGIC, 8) != 0 || std::memcmp(tail + 8, ColumnarFile::MAGIC, 8) != 0) {
+        std::cerr << "[Columnar]: " << path << " is not a columnar export" << std::endl;
+        return false;
+    }
+
+    std::uint64_t footer_offset = 0;
+    for (int i = 0; i < 8; i++) {
+        footer_offset |= (std::uint64_t)(unsigned char)tail[i] << (8 * i);
+    }
+    if (footer_offset < 8 || footer_offset > (std::uint64_t)size - 16) {
+        std::cerr << "[Columnar]: Corrupt footer offset in " << path << std::endl;
+        return false;
+    }
+    std::string footer((std::size_t)((std::uint64_t)size - 16 - footer_offset), '\0');
+    in.seekg((std::streamoff)footer_offset);
+    in.read(&footer[0], (std::streamsize)footer.size());
+    _bytes_read += footer.size() + 24;
+
+    const char* p = footer.data();
+    const char* end = p + footer.size();
+    std::uint64_t num_columns, num_blocks, v;
+    bool ok = get_varint(p, end, num_columns);
+    for (std::uint64_t c = 0; ok && c < num_columns; c++) {
+        ColumnarFile::Column col;
+        ok = end - p >= 2;
+        if (!ok) break;
+        col.type = (ColumnarFile::Type)(std::uint8_t)*p++;
+        col.encoding = (ColumnarFile::Encoding)(std::uint8_t)*p++;
+        ok = get_string(p, end, col.name);
+        schema.push_back(col);
+    }
+    ok = ok && get_varint(p, end, num_blocks);
+    for (std::uint64_t b = 0; ok && b < num_blocks; b++) {
+        ColumnarFile::Block block;
+        ok = get_varint(p, end, block.rows);
+        for (std::uint64_t c = 0; ok && c < num_columns; c++) {
+            ColumnarFile::Chunk chunk;
+            ok = get_varint(p, end, chunk.offset) && get_varint(p, end, chunk.length) && p < end;
+            if (!ok) break;
+            chunk.has_stats = *p++ != 0;
+            ok = get_varint(p, end, v);
+            chunk.min = unzigzag(v);
+            ok = ok && get_varint(p, end, v);
+            chunk.max = unzigzag(v);
+            block.chunks.push_back(chunk);
+        }
+        block_index.push_back(block);
+    }
+    if (!ok) {
+        std::cerr << "[Columnar]: Corrupt footer in " << path << std::endl;
+        schema.clear();
+        block_index.clear();
+        return false;
+    }
+    return true;
+}
+
+std::uint64_t ColumnarReader::row_count() const {
+    std::uint64_t rows = 0;
+    for (const ColumnarFile::Block& block : block_index) {
+        rows += block.rows;
+    }
+    return rows;
+}
+
+int ColumnarReader::column_index(const std::string& name) const {
+    for (std::size_t c = 0; c < schema.size(); c++) {
+        if (schema[c].name == name) return (int)c;
+    }
+    return -1;
+}
+
+bool ColumnarReader::read_chunk(const ColumnarFile::Chunk& chunk, std::string& buf) {
+    buf.resize((std::size_t)chunk.length);
+    in.seekg((std::streamoff)chunk.offset);
+    in.read(&buf[0], (std::streamsize)buf.size());
+    _bytes_read += chunk.length;
+    return (bool)in;
+}
+
+bool ColumnarReader::scan_int(const std::string& column, const std::function<void(std::int64_t)>& visit) {
+    return scan_int_range(column, INT64_MIN, INT64_MAX, visit);
+}
+
+bool ColumnarReader::scan_int_range(const std::string& column, std::int64_t lo, std::int64_t hi,
+                                    const std::function<void(std::int64_t)>& visit) {
+    int c = column_index(column);
+    if (c < 0 || schema[c].type != ColumnarFile::Type::Int64) {
+        return false;
+    }
+    bool delta = schema[c].encoding == ColumnarFile::Encoding::Delta;
+    std::string buf;
+    for (const ColumnarFile::Block& block : block_index) {
+        const ColumnarFile::Chunk& chunk = block.chunks[c];
+        if (chunk.has_stats && (chunk.max < lo || chunk.min > hi)) {
+            continue; // Nothing in this block can match
+        }
+        if (!read_chunk(chunk, buf)) return false;
+
+        const char* p = buf.data();
+        const char* end = p + buf.size();
+        std::int64_t prev = 0;
+        for (std::uint64_t r = 0; r < block.rows; r++) {
+            std::uint64_t raw;
+            if (!get_varint(p, end, raw)) return false;
+            std::int64_t value = delta ? prev + unzigzag(raw) : unzigzag(raw);
+            prev = value;
+            if (value >= lo && value <= hi) {
+                visit(value);
+            }
+        }
+    }
+    return true;
+}
+
+bool ColumnarReader::scan_string(const std::string& column, const std::function<void(const std::string&)>& visit) {
+    int c = column_index(column);
+    if (c < 0 || schema[c].type != ColumnarFile::Type::String) {
+        return false;
+    }
+    bool dictionary = schema[c].encoding == ColumnarFile::Encoding::Dictionary;
+    std::string buf;
+    std::string value;
+    for (const ColumnarFile::Block& block : block_index) {
+        if (!read_chunk(block.chunks[c], buf)) return false;
+        const char* p = buf.data();
+        const char* end = p + buf.size();
+
+        if (dictionary) {
+            std::uint64_t dict_size;
+            if (!get_varint(p, end, dict_size)) return false;
+            std::vector<std::string> dict((std::size_t)dict_size);
+            for (std::string& d : dict) {
+                if (!get_string(p, end, d)) return false;
+            }
+            for (std::uint64_t r = 0; r < block.rows; r++) {
+                std::uint64_t code;
+                if (!get_varint(p, end, code) || code >= dict.size()) return false;
+                visit(dict[(std::size_t)code]);
+            }
+        } else {
+            for (std::uint64_t r = 0; r < block.rows; r++) {
+                if (!get_string(p, end, value)) return false;
+                visit(value);
+            }
+        }
+    }
+    return true;
+}
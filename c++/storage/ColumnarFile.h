@@ -0,0 +1,135 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <vector>
+#include "../models/Task.h"
+
+/*
+ * Self-describing columnar file for analytics exports of the Tasks
+ * table (a much smaller cousin of Parquet).
+ *
+ * Layout:
+ *   "BWDCOL01"
+ *   block 0: chunk(task_id) chunk(assignee_id) ... chunk(created_at)
+ *   block 1: ...
+ *   footer:  schema (name, type, encoding per column),
+ *            per block: row count, and per column chunk its
+ *            offset, length and (optionally) min/max
+ *   u64 footer_offset | "BWDCOL01"
+ *
+ * Because the footer records where every column chunk lives, a
+ * reader can scan one column by seeking straight to its chunks,
+ * without reading the bytes of any other column. Blocks whose
+ * min/max can't match a range predicate are skipped entirely.
+ *
+ * Encodings:
+ *   DELTA      - zigzag varint of the difference to the previous
+ *                value (task_id, created_at: sorted or nearly so)
+ *   PLAIN      - zigzag varint ints / length-prefixed strings
+ *   DICTIONARY - distinct strings once per chunk, then one varint
+ *                code per row (status has only 3 values)
+ */
+class ColumnarFile {
+public:
+    enum class Type : std::uint8_t { Int64 = 1, String = 2 };
+    enum class Encoding : std::uint8_t { Plain = 1, Delta = 2, Dictionary = 3 };
+
+    struct Column {
+        std::string name;
+        Type type;
+        Encoding encoding;
+    };
+
+    // Location and stats of one column inside one block
+    struct Chunk {
+        std::uint64_t offset;
+        std::uint64_t length;
+        bool has_stats;
+        std::int64_t min; // Int64 columns only
+        std::int64_t max;
+    };
+
+    struct Block {
+        std::uint64_t rows;
+        std::vector<Chunk> chunks; // One per column, schema order
+    };
+
+    // The fixed schema used for Task exports
+    static std::vector<Column> task_schema();
+
+    static const char MAGIC[8];
+};
+
+/*
+ * Streams Tasks into a columnar file, one block of
+ * `rows_per_block` rows at a time, so memory use is bounded by the
+ * block size rather than the table size.
+ */
+class ColumnarWriter {
+public:
+    ColumnarWriter(std::string path, std::size_t rows_per_block = 65536, bool write_stats = true);
+
+    // Returns false (and logs why) if the file can't be created
+    bool open();
+    void append(const Task& task);
+    // Flushes the last block and writes the footer
+    bool close();
+
+    std::uint64_t rows_written() const { return total_rows; }
+
+private:
+    std::string path;
+    std::size_t rows_per_block;
+    bool write_stats;
+    std::ofstream out;
+    std::vector<ColumnarFile::Column> schema;
+    std::vector<ColumnarFile::Block> blocks;
+    std::uint64_t total_rows;
+
+    // Current block, buffered column by column
+    std::vector<std::vector<std::int64_t>> int_values;
+    std::vector<std::vector<std::string>> string_values;
+
+    void flush_block();
+};
+
+/*
+ * Reads the schema and footer on open(); column data is only read
+ * when a column is scanned.
+ */
+class ColumnarReader {
+public:
+    explicit ColumnarReader(std::string path);
+
+    // Returns false (and logs why) if the file isn't a valid export
+    bool open();
+
+    const std::vector<ColumnarFile::Column>& columns() const { return schema; }
+    const std::vector<ColumnarFile::Block>& blocks() const { return block_index; }
+    std::uint64_t row_count() const;
+
+    // Visit every value of one column, reading only that column's chunks.
+    // Return false if the column doesn't exist or has a different type.
+    bool scan_int(const std::string& column, const std::function<void(std::int64_t)>& visit);
+    bool scan_string(const std::string& column, const std::function<void(const std::string&)>& visit);
+
+    // Like scan_int, but skips blocks whose min/max rule out [lo, hi]
+    // and only visits values inside the range.
+    bool scan_int_range(const std::string& column, std::int64_t lo, std::int64_t hi,
+                        const std::function<void(std::int64_t)>& visit);
+
+    std::uint64_t bytes_read() const { return _bytes_read; }
+
+private:
+    std::string path;
+    std::ifstream in;
+    std::vector<ColumnarFile::Column> schema;
+    std::vector<ColumnarFile::Block> block_index;
+    std::uint64_t _bytes_read;
+
+    int column_index(const std::string& name) const;
+    bool read_chunk(const ColumnarFile::Chunk& chunk, std::string& buf);
+};
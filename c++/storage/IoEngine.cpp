@@ -0,0 +1,266 @@
+#include "IoEngine.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+
+// POSIX / Linux headers
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+
+// --- Helpers ---
+
+// Writes data[0..len) at offset, retrying short writes.
+static bool pwrite_all(int fd, const char* data, std::size_t len, off_t offset) {
+    while (len > 0) {
+        ssize_t w = pwrite(fd, data, len, offset);
+        if (w < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += w;
+        len -= (std::size_t)w;
+        offset += w;
+    }
+    return true;
+}
+
+// --- IoEngine ---
+
+std::unique_ptr<IoEngine> IoEngine::create(Backend backend) {
+    if (backend != Backend::Pwrite) {
+        std::unique_ptr<UringIoEngine> uring = UringIoEngine::create();
+        if (uring) {
+            return uring;
+        }
+        if (backend == Backend::Uring) {
+            return nullptr;
+        }
+    }
+    return std::unique_ptr<IoEngine>(new PwriteIoEngine());
+}
+
+// --- PwriteIoEngine ---
+
+bool PwriteIoEngine::write_and_sync(int fd, const std::vector<IoWrite>& writes) {
+    for (const IoWrite& w : writes) {
+        if (!pwrite_all(fd, w.data, w.len, w.offset)) {
+            return false;
+        }
+    }
+    return fdatasync(fd) == 0;
+}
+
+// --- UringIoEngine ---
+
+/*
+ * The three shared mappings io_uring gives us, plus pointers to the
+ * fields we touch. Head/tail indices are shared with the kernel, so
+ * they are read with acquire and written with release semantics.
+ */
+struct UringIoEngine::Ring {
+    int fd = -1;
+    void* sq_ptr = MAP_FAILED;
+    void* cq_ptr = MAP_FAILED;
+    std::size_t sq_size = 0;
+    std::size_t cq_size = 0;
+    io_uring_sqe* sqes = (io_uring_sqe*)MAP_FAILED;
+    std::size_t sqes_size = 0;
+
+    unsigned entries = 0;
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_mask = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned* cq_mask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+
+    ~Ring() {
+        if (sqes != MAP_FAILED) munmap(sqes, sqes_size);
+        if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr) munmap(cq_ptr, cq_size);
+        if (sq_ptr != MAP_FAILED) munmap(sq_ptr, sq_size);
+        if (fd >= 0) close(fd);
+    }
+};
+
+UringIoEngine::UringIoEngine(std::unique_ptr<Ring> r) : ring(std::move(r)) {}
+
+/*
+ * Kernels 5.1-5.5 set up a ring but reject IORING_OP_WRITE in the
+ * completion with -EINVAL, which would fail every WAL append. Ask the
+ * kernel which opcodes it knows (IORING_REGISTER_PROBE, itself 5.6+,
+ * so an error here also means "too old").
+ */
+bool UringIoEngine::supports_ops(int ring_fd) {
+    const unsigned NUM_OPS = 256;
+    std::vector<char> buf(sizeof(io_uring_probe) + NUM_OPS * sizeof(io_uring_probe_op), 0);
+    io_uring_probe* probe = (io_uring_probe*)buf.data();
+    if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, probe, NUM_OPS) < 0) {
+        return false;
+    }
+    auto supported = [probe](unsigned op) {
+        return op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+    };
+    return supported(IORING_OP_WRITE) && supported(IORING_OP_FSYNC);
+}
+
+UringIoEngine::~UringIoEngine() {}
+
+std::unique_ptr<UringIoEngine> UringIoEngine::create(unsigned entries) {
+    std::unique_ptr<Ring> r(new Ring());
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    r->fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+    if (r->fd < 0) {
+        return nullptr; // ENOSYS, EPERM (seccomp), ...
+    }
+    if (!supports_ops(r->fd)) {
+        return nullptr;
+    }
+    r->entries = params.sq_entries;
+
+    r->sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    r->cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single_mmap) {
+        r->sq_size = r->cq_size = (r->sq_size > r->cq_size ? r->sq_size : r->cq_size);
+    }
+
+    r->sq_ptr = mmap(nullptr, r->sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     r->fd, IORING_OFF_SQ_RING);
+    if (r->sq_ptr == MAP_FAILED) return nullptr;
+    r->cq_ptr = single_mmap ? r->sq_ptr
+                            : mmap(nullptr, r->cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                   r->fd, IORING_OFF_CQ_RING);
+    if (r->cq_ptr == MAP_FAILED) return nullptr;
+    r->sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+    r->sqes = (io_uring_sqe*)mmap(nullptr, r->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                  r->fd, IORING_OFF_SQES);
+    if (r->sqes == MAP_FAILED) return nullptr;
+
+    char* sq = (char*)r->sq_ptr;
+    char* cq = (char*)r->cq_ptr;
+    r->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    r->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    r->sq_array = (unsigned*)(sq + params.sq_off.array);
+    r->cq_head = (unsigned*)(cq + params.cq_off.head);
+    r->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    r->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    r->cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+    return std::unique_ptr<UringIoEngine>(new UringIoEngine(std::move(r)));
+}
+
+/*
+ * Submits writes[first, first+count) (and, if `sync`, a datasync
+ * linked after them) in one io_uring_enter, then reaps every
+ * completion. Bytes written per buffer are accumulated in `written`.
+ * Returns false only on a hard error; short writes are left for the
+ * caller to finish.
+ */
+bool UringIoEngine::submit_round(int fd, const std::vector<IoWrite>& writes, std::size_t first, std::size_t count,
+                                 bool sync, std::vector<std::size_t>& written) {
+    const std::uint64_t SYNC_TAG = ~(std::uint64_t)0;
+    unsigned tail = *ring->sq_tail; // Only we write the SQ tail
+    unsigned mask = *ring->sq_mask;
+
+    for (std::size_t i = first; i < first + count; i++) {
+        unsigned idx = tail & mask;
+        io_uring_sqe* sqe = &ring->sqes[idx];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_WRITE;
+        sqe->fd = fd;
+        sqe->addr = (std::uint64_t)(uintptr_t)writes[i].data;
+        sqe->len = (unsigned)writes[i].len;
+        sqe->off = (std::uint64_t)writes[i].offset;
+        sqe->flags = sync ? IOSQE_IO_LINK : 0; // fsync must wait for every write
+        sqe->user_data = i;
+        ring->sq_array[idx] = idx;
+        tail++;
+    }
+    unsigned submitted = (unsigned)count;
+    if (sync) {
+        unsigned idx = tail & mask;
+        io_uring_sqe* sqe = &ring->sqes[idx];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_FSYNC;
+        sqe->fd = fd;
+        sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+        sqe->user_data = SYNC_TAG;
+        ring->sq_array[idx] = idx;
+        tail++;
+        submitted++;
+    }
+    __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+
+    unsigned to_submit = submitted;
+    unsigned reaped = 0;
+    bool ok = true;
+    while (reaped < submitted) {
+        int ret = (int)syscall(__NR_io_uring_enter, ring->fd, to_submit, submitted - reaped,
+                               IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (ret < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        to_submit -= (unsigned)ret < to_submit ? (unsigned)ret : to_submit;
+
+        unsigned head = *ring->cq_head;
+        while (head != __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE)) {
+            io_uring_cqe* cqe = &ring->cqes[head & *ring->cq_mask];
+            if (cqe->user_data == SYNC_TAG) {
+                // -ECANCELED just means a linked write came up short
+                if (cqe->res < 0 && cqe->res != -ECANCELED) {
+                    errno = -cqe->res;
+                    ok = false;
+                }
+            } else if (cqe->res < 0) {
+                if (cqe->res != -ECANCELED) {
+                    errno = -cqe->res;
+                    ok = false;
+                }
+            } else {
+                written[cqe->user_data] += (std::size_t)cqe->res;
+            }
+            head++;
+            reaped++;
+        }
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    }
+    return ok;
+}
+
+bool UringIoEngine::write_and_sync(int fd, const std::vector<IoWrite>& writes) {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::vector<std::size_t> written(writes.size(), 0);
+
+    // Leave one SQE free for the datasync in the final round
+    std::size_t per_round = ring->entries - 1;
+    std::size_t first = 0;
+    do {
+        std::size_t count = writes.size() - first < per_round ? writes.size() - first : per_round;
+        bool last = first + count == writes.size();
+        if (!submit_round(fd, writes, first, count, last, written)) {
+            return false;
+        }
+        first += count;
+    } while (first < writes.size());
+
+    // Finish any short (or cancelled) writes synchronously
+    bool incomplete = false;
+    for (std::size_t i = 0; i < writes.size(); i++) {
+        if (written[i] < writes[i].len) {
+            incomplete = true;
+            if (!pwrite_all(fd, writes[i].data + written[i], writes[i].len - written[i],
+                            writes[i].offset + (off_t)written[i])) {
+                return false;
+            }
+        }
+    }
+    return incomplete ? fdatasync(fd) == 0 : true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+// One buffer to write at a given file offset.
+struct IoWrite {
+    const char* data;
+    std::size_t len;
+    off_t offset;
+};
+
+/*
+ * Batched file I/O for local persistence (WAL appends).
+ *
+ * Two backends:
+ * - Uring:  all writes of a batch plus the trailing fdatasync go to
+ *           the kernel in one io_uring_enter() call, and all their
+ *           completions are reaped together.
+ * - Pwrite: the portable fallback, one pwrite() per buffer and then
+ *           fdatasync().
+ *
+ * `Auto` picks io_uring when the kernel allows it and supports the
+ * opcodes we use (it is often disabled in containers, and kernels
+ * before 5.6 lack IORING_OP_WRITE) and silently falls back otherwise.
+ * Engines are safe to share between threads.
+ */
+class IoEngine {
+public:
+    enum class Backend { Auto, Uring, Pwrite };
+
+    // Returns nullptr only if `Uring` was explicitly requested and
+    // io_uring is unavailable.
+    static std::unique_ptr<IoEngine> create(Backend backend = Backend::Auto);
+
+    virtual ~IoEngine() {}
+
+    // Writes every buffer, then makes the data durable with a single
+    // fdatasync. Returns false (errno set) if any step failed.
+    virtual bool write_and_sync(int fd, const std::vector<IoWrite>& writes) = 0;
+
+    virtual const char* name() const = 0;
+};
+
+// Fallback backend: plain pwrite + fdatasync.
+class PwriteIoEngine : public IoEngine {
+public:
+    bool write_and_sync(int fd, const std::vector<IoWrite>& writes) override;
+    const char* name() const override { return "pwrite"; }
+};
+
+// io_uring backend, talking to the kernel directly (no liburing).
+class UringIoEngine : public IoEngine {
+public:
+    // Returns nullptr if io_uring_setup fails or the kernel lacks the
+    // write/fsync opcodes.
+    static std::unique_ptr<UringIoEngine> create(unsigned entries = 64);
+    ~UringIoEngine() override;
+
+    bool write_and_sync(int fd, const std::vector<IoWrite>& writes) override;
+    const char* name() const override { return "io_uring"; }
+
+private:
+    struct Ring; // Mapped submission/completion queues
+    std::unique_ptr<Ring> ring;
+    std::mutex mtx; // One batch in flight at a time
+
+    explicit UringIoEngine(std::unique_ptr<Ring> r);
+    static bool supports_ops(int ring_fd);
+    bool submit_round(int fd, const std::vector<IoWrite>& writes, std::size_t first, std::size_t count,
+                      bool sync, std::vector<std::size_t>& written);
+};
@@ -0,0 +1,119 @@
+#include "TaskHistory.h"
+#include <iostream>
+
+TaskHistory::TaskHistory(DatabaseConnector* history_db, std::size_t batch, std::size_t recent, std::size_t max_tasks)
+    : db(history_db), batch_size(batch < 1 ? 1 : batch), recent_per_task(recent < 1 ? 1 : recent),
+      max_cached_tasks(max_tasks < 1 ? 1 : max_tasks) {}
+
+TaskHistory::~TaskHistory() {
+    flush();
+}
+
+void TaskHistory::record(int task_id, const std::string& status, int priority, std::int64_t changed_at_us) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = tasks.find(task_id);
+    if (found == tasks.end()) {
+        // New (or evicted) task: make room, its first row is a keyframe
+        if (tasks.size() >= max_cached_tasks) {
+            tasks.erase(lru.back());
+            lru.pop_back();
+        }
+        lru.push_front(task_id);
+        found = tasks.emplace(task_id, TaskVersions()).first;
+        found->second.lru_pos = lru.begin();
+    } else {
+        lru.splice(lru.begin(), lru, found->second.lru_pos);
+    }
+    TaskVersions& versions = found->second;
+
+    TaskHistoryRow row;
+    row.task_id = task_id;
+    row.changed_at_us = changed_at_us;
+    row.status = status;
+    row.priority = priority;
+    if (versions.recent.empty() || versions.since_keyframe + 1 >= KEYFRAME_INTERVAL) {
+        row.keyframe = true;
+        row.fields = TaskHistoryRow::STATUS | TaskHistoryRow::PRIORITY;
+    } else {
+        // Delta against the previous version
+        const TaskVersion& last = versions.recent.back();
+        if (last.status != status) row.fields |= TaskHistoryRow::STATUS;
+        if (last.priority != priority) row.fields |= TaskHistoryRow::PRIORITY;
+        if (row.fields == 0) return;
+    }
+    versions.since_keyframe = row.keyframe ? 0 : versions.since_keyframe + 1;
+    buffer.push_back(row);
+
+    versions.recent.push_back(TaskVersion{changed_at_us, status, priority});
+    if (versions.recent.size() > recent_per_task) {
+        versions.recent.pop_front();
+    }
+
+    if (buffer.size() >= batch_size) {
+        flush_locked();
+    }
+}
+
+bool TaskHistory::flush() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return flush_locked();
+}
+
+bool TaskHistory::flush_locked() {
+    if (buffer.empty()) {
+        return true;
+    }
+    if (!db->insertTaskHistory(buffer)) {
+        std::cerr << "[History]: Keeping " << buffer.size() << " rows buffered for the next flush" << std::endl;
+        return false;
+    }
+    buffer.clear();
+    return true;
+}
+
+bool TaskHistory::stateAt(int task_id, std::int64_t at_us, TaskVersion& out) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    // Recent history: answer from memory (newest first)
+    auto it = tasks.find(task_id);
+    if (it != tasks.end() && !it->second.recent.empty() && it->second.recent.front().changed_at_us <= at_us) {
+        const std::deque<TaskVersion>& recent = it->second.recent;
+        for (auto v = recent.rbegin(); v != recent.rend(); ++v) {
+            if (v->changed_at_us <= at_us) {
+                out = *v;
+                return true;
+            }
+        }
+    }
+
+    // Older: nearest keyframe + the deltas after it. Buffered rows are
+    // all newer than what memory covers, but write them so the DB is
+    // complete anyway.
+    flush_locked();
+    std::vector<TaskHistoryRow> rows = db->getTaskHistoryAt(task_id, at_us, KEYFRAME_INTERVAL);
+    if (rows.empty()) {
+        return false;
+    }
+    TaskVersion state;
+    for (const TaskHistoryRow& row : rows) {
+        if (row.fields & TaskHistoryRow::STATUS) state.status = row.status;
+        if (row.fields & TaskHistoryRow::PRIORITY) state.priority = row.priority;
+        state.changed_at_us = row.changed_at_us;
+    }
+    out = state;
+    return true;
+}
+
+std::vector<TaskVersion> TaskHistory::recent(int task_id) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = tasks.find(task_id);
+    if (it == tasks.end()) {
+        return {};
+    }
+    return std::vector<TaskVersion>(it->second.recent.begin(), it->second.recent.end());
+}
+
+std::size_t TaskHistory::buffered_rows() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return buffer.size();
+}
@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../db/DatabaseConnector.h"
+
+// A task's status and priority as of `changed_at_us`
+struct TaskVersion {
+    std::int64_t changed_at_us = 0; // Unix microseconds
+    std::string status;
+    int priority = 0;
+};
+
+/*
+ * Every status and priority a task has had.
+ *
+ * record() is called once per change. Versions are written to the
+ * TaskHistory table delta-encoded: a row only stores the fields that
+ * changed, and every KEYFRAME_INTERVAL-th row of a task is a full
+ * keyframe. Rows are buffered and written `batch_size` at a time
+ * (multi-row INSERTs in one transaction); flush() writes the rest.
+ *
+ * The last `recent_per_task` versions of each task are kept decoded
+ * in memory, so point-in-time queries about recent history never hit
+ * the DB. Older ones read the nearest keyframe plus at most
+ * KEYFRAME_INTERVAL - 1 deltas, not the task's whole history.
+ *
+ * At most `max_cached_tasks` tasks are kept in memory; the least
+ * recently changed ones are evicted, and queries about them go to
+ * the DB. The first change seen for a task after startup (or after
+ * its eviction) is always a keyframe, so no DB read is needed to
+ * pick up where it left off.
+ *
+ * Thread-safe. `history_db` should be a connection of its own; it is
+ * only used under this object's lock.
+ */
+class TaskHistory {
+public:
+    static const int KEYFRAME_INTERVAL = 16;
+
+    TaskHistory(DatabaseConnector* history_db, std::size_t batch_size = 256, std::size_t recent_per_task = 32,
+                std::size_t max_cached_tasks = 10000);
+    ~TaskHistory();
+
+    TaskHistory(const TaskHistory&) = delete;
+    TaskHistory& operator=(const TaskHistory&) = delete;
+
+    // Task `task_id` now has this status and priority. Writes a batch
+    // once enough rows are buffered. Unchanged states are ignored.
+    void record(int task_id, const std::string& status, int priority, std::int64_t changed_at_us);
+
+    // Write every buffered row. Returns false if the INSERT failed
+    // (the rows stay buffered for the next attempt).
+    bool flush();
+
+    // The task's state as of `at_us`. Returns false if it has no
+    // recorded version that old.
+    bool stateAt(int task_id, std::int64_t at_us, TaskVersion& out);
+
+    // The versions kept in memory for `task_id`, oldest first
+    std::vector<TaskVersion> recent(int task_id) const;
+
+    std::size_t buffered_rows() const;
+
+private:
+    struct TaskVersions {
+        std::deque<TaskVersion> recent; // Newest at the back
+        int since_keyframe = 0;         // Deltas written after the last keyframe
+        std::list<int>::iterator lru_pos;
+    };
+
+    DatabaseConnector* db; // Not owned
+    std::size_t batch_size;
+    std::size_t recent_per_task;
+    std::size_t max_cached_tasks;
+
+    mutable std::mutex mutex;
+    std::unordered_map<int, TaskVersions> tasks;
+    std::list<int> lru; // Task ids, most recently changed first
+    std::vector<TaskHistoryRow> buffer;
+
+    bool flush_locked();
+};
@@ -0,0 +1,406 @@
+#include "WriteAheadLog.h"
+#include "../ingest/IngestProtocol.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// POSIX headers
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const std::size_t RECORD_HEADER_SIZE = 16; // length, crc32, lsn
+
+// --- Helpers ---
+
+// Standard CRC-32 (IEEE), table built (thread-safely) on first use
+static std::uint32_t crc32(const char* data, std::size_t len) {
+    static const std::array<std::uint32_t, 256> table = [] {
+        std::array<std::uint32_t, 256> t;
+        for (std::uint32_t i = 0; i < 256; i++) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < len; i++) {
+        crc = table[(crc ^ (unsigned char)data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+static void store_le(char* p, std::uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        p[i] = (char)((v >> (8 * i)) & 0xFF);
+    }
+}
+
+static std::uint64_t load_le(const char* p, int bytes) {
+    std::uint64_t v = 0;
+    for (int i = 0; i < bytes; i++) {
+        v |= (std::uint64_t)(unsigned char)p[i] << (8 * i);
+    }
+    return v;
+}
+
+// Makes a newly created/removed file name durable
+static void sync_directory(const std::string& dir) {
+    int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+// --- WriteAheadLog ---
+
+WriteAheadLog::WriteAheadLog(std::string d, std::size_t max_bytes, IoEngine::Backend backend)
+    : dir(d), max_segment_bytes(max_bytes), io(IoEngine::create(backend)), next_lsn(1), durable(0), flushing(false), failed(false),
+      active_fd(-1), active_size(0), persisted(0), checkpoint_fd(-1) {}
+
+WriteAheadLog::~WriteAheadLog() {
+    if (active_fd >= 0) {
+        close(active_fd);
+    }
+    if (checkpoint_fd >= 0) {
+        close(checkpoint_fd);
+    }
+}
+
+std::string WriteAheadLog::segment_path(std::uint64_t first_lsn) const {
+    char name[40];
+    std::snprintf(name, sizeof(name), "wal-%020llu.log", (unsigned long long)first_lsn);
+    return dir + "/" + name;
+}
+
+bool WriteAheadLog::open(std::vector<std::unique_ptr<Task>>& recovered) {
+    std::lock_guard<std::mutex> lock(mtx);
+
+    if (!io) {
+        std::cerr << "[WAL]: Requested I/O backend is not available" << std::endl;
+        return false;
+    }
+    if (mkdir(dir.c_str(), 0755) < 0 && errno != EEXIST) {
+        std::cerr << "[WAL]: Cannot create " << dir << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Collect existing segments; the zero-padded names sort by LSN
+    DIR* d = opendir(dir.c_str());
+    if (!d) {
+        std::cerr << "[WAL]: Cannot open " << dir << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    std::vector<std::string> names;
+    while (dirent* entry = readdir(d)) {
+        std::string name = entry->d_name;
+        if (name.size() == 28 && name.compare(0, 4, "wal-") == 0 && name.compare(24, 4, ".log") == 0) {
+            names.push_back(name);
+        }
+    }
+    closedir(d);
+    std::sort(names.begin(), names.end());
+
+    // The checkpoint tells us which records are already in the DB
+    std::string checkpoint_path = dir + "/wal.checkpoint";
+    checkpoint_fd = ::open(checkpoint_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (checkpoint_fd < 0) {
+        std::cerr << "[WAL]: Cannot open " << checkpoint_path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    char cp[8];
+    if (pread(checkpoint_fd, cp, sizeof(cp), 0) == (ssize_t)sizeof(cp)) {
+        persisted = load_le(cp, 8);
+    }
+
+    std::size_t before = recovered.size();
+    std::uint64_t max_lsn = persisted;
+    for (std::size_t i = 0; i < names.size(); i++) {
+        std::string path = dir + "/" + names[i];
+        std::uint64_t first_lsn = std::stoull(names[i].substr(4, 20));
+        max_lsn = std::max(max_lsn, first_lsn - 1);
+
+        // Only the last segment can end in a torn write; anything cut
+        // off there was never acknowledged
+        bool last = i + 1 == names.size();
+        if (replay_segment(path, last, recovered, max_lsn) || last) {
+            segments.push_back({first_lsn, path});
+            continue;
+        }
+        // Later segments hold acknowledged records, so keep going, but
+        // set this one aside for inspection instead of reusing it
+        std::string aside = path + ".corrupt";
+        if (std::rename(path.c_str(), aside.c_str()) < 0) {
+            std::cerr << "[WAL]: Cannot move aside " << path << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        std::cerr << "[WAL]: Corrupt record in " << path << ", moved to " << aside << std::endl;
+    }
+    if (recovered.size() > before) {
+        std::cout << "[WAL]: Recovered " << recovered.size() - before << " unpersisted tasks" << std::endl;
+    }
+    std::cout << "[WAL]: Logging to " << dir << " using " << io->name() << std::endl;
+
+    // Keep LSNs increasing across restarts: above every record and
+    // every segment name seen, including segments after a corrupt one
+    next_lsn = max_lsn + 1;
+    durable = max_lsn;
+
+    // New appends always go to a fresh segment
+    if (!open_segment(next_lsn)) {
+        return false;
+    }
+    remove_persisted_segments();
+    return true;
+}
+
+bool WriteAheadLog::replay_segment(const std::string& path, bool truncate_torn,
+                                   std::vector<std::unique_ptr<Task>>& recovered,
+                                   std::uint64_t& max_lsn) {
+    int fd = ::open(path.c_str(), O_RDWR | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "[WAL]: Cannot read " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    std::string contents;
+    char buf[64 * 1024];
+    ssize_t r;
+    while ((r = read(fd, buf, sizeof(buf))) > 0) {
+        contents.append(buf, (std::size_t)r);
+    }
+
+    std::size_t offset = 0;
+    bool intact = true;
+    while (offset < contents.size()) {
+        if (contents.size() - offset < RECORD_HEADER_SIZE) {
+            intact = false;
+            break;
+        }
+        const char* rec = contents.data() + offset;
+        std::uint32_t len = (std::uint32_t)load_le(rec, 4);
+        std::uint32_t crc = (std::uint32_t)load_le(rec + 4, 4);
+        std::uint64_t lsn = load_le(rec + 8, 8);
+        if (contents.size() - offset - RECORD_HEADER_SIZE < len ||
+            crc32(rec + 8, 8 + len) != crc) {
+            intact = false;
+            break;
+        }
+
+        const char* p = rec + RECORD_HEADER_SIZE;
+        std::unique_ptr<Task> task = IngestProtocol::decode_record(p, p + len);
+        if (!task) {
+            intact = false;
+            break;
+        }
+        // Records at or below the checkpoint already reached the DB
+        if (lsn > persisted) {
+            task->wal_lsn = lsn;
+            task->enqueued_at = std::chrono::steady_clock::now();
+            recovered.push_back(std::move(task));
+        }
+        max_lsn = std::max(max_lsn, lsn);
+        offset += RECORD_HEADER_SIZE + len;
+    }
+
+    if (!intact && truncate_torn) {
+        std::cerr << "[WAL]: Truncating torn record in " << path << " at offset " << offset << std::endl;
+        if (ftruncate(fd, (off_t)offset) == 0) {
+            fdatasync(fd);
+        }
+    }
+    close(fd);
+    return intact;
+}
+
+bool WriteAheadLog::open_segment(std::uint64_t first_lsn) {
+    std::string path = segment_path(first_lsn);
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "[WAL]: Cannot create segment " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    sync_directory(dir);
+
+    if (active_fd >= 0) {
+        close(active_fd);
+    }
+    active_fd = fd;
+    off_t end = lseek(fd, 0, SEEK_END); // Non-zero when reusing the last segment
+    active_size = end > 0 ? (std::size_t)end : 0;
+    if (segments.empty() || segments.back().first_lsn != first_lsn) {
+        segments.push_back({first_lsn, path});
+    }
+    return true;
+}
+
+// Requires mtx. Encodes `task` into the group-commit buffer.
+std::uint64_t WriteAheadLog::buffer_record(const Task& task) {
+    std::uint64_t lsn = next_lsn++;
+    std::size_t len = IngestProtocol::record_size(task);
+    std::size_t at = pending.size();
+    pending.resize(at + RECORD_HEADER_SIZE + len);
+    char* rec = &pending[at];
+    store_le(rec, len, 4);
+    store_le(rec + 8, lsn, 8);
+    IngestProtocol::encode_record(task, rec + RECORD_HEADER_SIZE);
+    store_le(rec + 4, crc32(rec + 8, 8 + len), 4);
+    return lsn;
+}
+
+// Requires mtx (held by `lock`). Either waits for the current leader,
+// or becomes the leader, until `lsn` is durable or the log fails.
+bool WriteAheadLog::wait_durable(std::unique_lock<std::mutex>& lock, std::uint64_t lsn) {
+    while (durable < lsn && !failed) {
+        if (flushing) {
+            flushed.wait(lock);
+            continue;
+        }
+
+        flushing = true;
+        std::string batch;
+        batch.swap(pending);
+        std::uint64_t batch_last = next_lsn - 1;
+        std::vector<IoWrite> writes = {{batch.data(), batch.size(), (off_t)active_size}};
+
+        // Write and sync without holding the lock so others can buffer
+        lock.unlock();
+        bool ok = io->write_and_sync(active_fd, writes);
+        lock.lock();
+
+        flushing = false;
+        if (!ok) {
+            std::cerr << "[WAL]: Write failed: " << std::strerror(errno) << std::endl;
+            failed = true;
+        } else {
+            durable = batch_last;
+            active_size += batch.size();
+            if (active_size >= max_segment_bytes && !open_segment(batch_last + 1)) {
+                failed = true;
+            }
+        }
+        flushed.notify_all();
+    }
+    return durable >= lsn;
+}
+
+std::uint64_t WriteAheadLog::append(const Task& task) {
+    std::unique_lock<std::mutex> lock(mtx);
+    if (failed || active_fd < 0) {
+        return 0;
+    }
+    std::uint64_t lsn = buffer_record(task);
+    return wait_durable(lock, lsn) ? lsn : 0;
+}
+
+bool WriteAheadLog::append_batch(std::vector<std::unique_ptr<Task>>& tasks) {
+    std::unique_lock<std::mutex> lock(mtx);
+    if (failed || active_fd < 0) {
+        return false;
+    }
+    std::uint64_t last = 0;
+    for (auto& task : tasks) {
+        if (task->wal_lsn == 0) {
+            task->wal_lsn = last = buffer_record(*task);
+        }
+    }
+    if (last == 0 || wait_durable(lock, last)) {
+        return true;
+    }
+    for (auto& task : tasks) {
+        if (task->wal_lsn > durable) task->wal_lsn = 0; // Not logged after all
+    }
+    return false;
+}
+
+void WriteAheadLog::mark_persisted(std::uint64_t lsn) {
+    std::lock_guard<std::mutex> lock(mtx);
+    confirm(lsn);
+}
+
+bool WriteAheadLog::mark_failed(const Task& task) {
+    if (task.wal_lsn == 0) {
+        return false;
+    }
+    // Same record format as the segments, so it can be inspected or
+    // replayed by hand
+    std::size_t len = IngestProtocol::record_size(task);
+    std::string rec(RECORD_HEADER_SIZE + len, '\0');
+    store_le(&rec[0], len, 4);
+    store_le(&rec[8], task.wal_lsn, 8);
+    IngestProtocol::encode_record(task, &rec[RECORD_HEADER_SIZE]);
+    store_le(&rec[4], crc32(&rec[8], 8 + len), 4);
+
+    std::lock_guard<std::mutex> lock(mtx);
+    std::string path = dir + "/wal.failed";
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    bool ok = fd >= 0 && write(fd, rec.data(), rec.size()) == (ssize_t)rec.size() && fdatasync(fd) == 0;
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (!ok) {
+        // Keep it in the log; it will be replayed on the next start
+        std::cerr << "[WAL]: Cannot set aside task LSN " << task.wal_lsn << " in " << path << ": "
+                  << std::strerror(errno) << std::endl;
+        return false;
+    }
+    std::cerr << "[WAL]: Task LSN " << task.wal_lsn << " could not be persisted, set aside in " << path << std::endl;
+    confirm(task.wal_lsn);
+    return true;
+}
+
+// Requires mtx. `lsn` no longer needs to be replayed.
+void WriteAheadLog::confirm(std::uint64_t lsn) {
+    if (lsn <= persisted) {
+        return;
+    }
+    confirmed.insert(lsn);
+    // Advance the watermark over every contiguous confirmation
+    std::uint64_t old = persisted;
+    while (!confirmed.empty() && *confirmed.begin() == persisted + 1) {
+        persisted++;
+        confirmed.erase(confirmed.begin());
+    }
+    if (persisted == old) {
+        return;
+    }
+
+    // Not fsynced: after a power loss an older checkpoint only
+    // means some tasks are replayed twice (at-least-once)
+    char cp[8];
+    store_le(cp, persisted, 8);
+    if (pwrite(checkpoint_fd, cp, sizeof(cp), 0) != (ssize_t)sizeof(cp)) {
+        std::cerr << "[WAL]: Failed to write checkpoint: " << std::strerror(errno) << std::endl;
+    }
+    remove_persisted_segments();
+}
+
+// Requires mtx. A segment can go once the next one starts at or
+// below persisted + 1, i.e. every record it holds is persisted.
+void WriteAheadLog::remove_persisted_segments() {
+    std::size_t removable = 0;
+    while (removable + 1 < segments.size() && segments[removable + 1].first_lsn <= persisted + 1) {
+        removable++;
+    }
+    if (removable == 0) {
+        return;
+    }
+    for (std::size_t i = 0; i < removable; i++) {
+        unlink(segments[i].path.c_str());
+    }
+    segments.erase(segments.begin(), segments.begin() + removable);
+    sync_directory(dir);
+}
+
+std::uint64_t WriteAheadLog::durable_lsn() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return durable;
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include "../models/Task.h"
+#include "IoEngine.h"
+
+/*
+ * Local write-ahead log for the ingest path.
+ *
+ * submit_new_task appends every task here *before* it reaches
+ * new_task_queue, so a crash between submission and the MySQL INSERT
+ * loses nothing: on startup, open() replays the surviving records.
+ *
+ * Group commit: concurrent append() callers buffer their records and
+ * one of them (the "leader") writes the whole buffer and issues a
+ * single fdatasync for everyone. Followers just wait until the
+ * durable LSN covers their own record. The write and sync go through
+ * an IoEngine (io_uring when available, pwrite otherwise).
+ *
+ * The log is split into segment files (wal-<first_lsn>.log). Once
+ * process_new_task_queue confirms a task is in MySQL it calls
+ * mark_persisted(lsn); segments whose records are all persisted are
+ * deleted, and the watermark is saved in wal.checkpoint so records
+ * that were already persisted are skipped on replay. Delivery is
+ * at-least-once: a task persisted just before a crash (but not yet
+ * confirmed) is replayed again. A task that can't be persisted at all
+ * is moved to wal.failed (mark_failed) instead of holding the
+ * watermark back forever.
+ *
+ * On-disk record: u32 length | u32 crc32 | u64 lsn | IngestProtocol record
+ */
+class WriteAheadLog {
+public:
+    WriteAheadLog(std::string dir, std::size_t max_segment_bytes = 64 * 1024 * 1024,
+                  IoEngine::Backend backend = IoEngine::Backend::Auto);
+    ~WriteAheadLog();
+
+    // Scans existing segments, moving every intact record into
+    // `recovered` (with wal_lsn set), and opens a fresh segment for
+    // new appends. A torn record at the end of the last segment is
+    // cut off. A bad record in any earlier segment is corruption, not
+    // a torn write: that segment's intact prefix is recovered and the
+    // file is renamed to *.corrupt, and later segments are still
+    // replayed. Returns false (and logs why) if the log directory
+    // can't be used.
+    bool open(std::vector<std::unique_ptr<Task>>& recovered);
+
+    // Appends `task` and blocks until it is durable.
+    // Returns its LSN, or 0 if the write failed.
+    std::uint64_t append(const Task& task);
+
+    // Appends every task without a wal_lsn yet (setting it) with a
+    // single write and sync, and blocks until they are durable.
+    // Returns false if the write failed; those tasks keep wal_lsn 0.
+    bool append_batch(std::vector<std::unique_ptr<Task>>& tasks);
+
+    // The task with this LSN is safely in the database.
+    // Segments that only hold persisted records are removed.
+    void mark_persisted(std::uint64_t lsn);
+
+    // The task could not be persisted (the INSERT kept failing). Its
+    // record is appended to <dir>/wal.failed and synced, then its LSN
+    // counts as done so the watermark and segment cleanup move on.
+    // Returns false (and leaves the LSN unconfirmed) if that failed.
+    bool mark_failed(const Task& task);
+
+    std::uint64_t durable_lsn();
+
+private:
+    struct Segment {
+        std::uint64_t first_lsn;
+        std::string path;
+    };
+
+    std::string dir;
+    std::size_t max_segment_bytes;
+    std::unique_ptr<IoEngine> io;
+
+    std::mutex mtx;
+    std::condition_variable flushed;
+
+    // Group-commit state (guarded by mtx)
+    std::string pending;       // Encoded records waiting for the next flush
+    std::uint64_t next_lsn;    // LSN handed to the next append
+    std::uint64_t durable;     // Highest LSN known to be on disk
+    bool flushing;             // A leader is currently writing
+    bool failed;               // A write/fsync error poisoned the log
+
+    // Segment state (guarded by mtx; fd is only used by the leader)
+    std::vector<Segment> segments; // Oldest first; back() is active
+    int active_fd;
+    std::size_t active_size;
+
+    // Truncation state (guarded by mtx)
+    std::uint64_t persisted;            // All LSNs <= this are in the DB
+    std::set<std::uint64_t> confirmed;  // Out-of-order confirmations > persisted
+    int checkpoint_fd;                  // Holds `persisted` as a u64
+
+    std::uint64_t buffer_record(const Task& task);
+    bool wait_durable(std::unique_lock<std::mutex>& lock, std::uint64_t lsn);
+    void confirm(std::uint64_t lsn);
+    bool open_segment(std::uint64_t first_lsn);
+    bool replay_segment(const std::string& path, bool truncate_torn, std::vector<std::unique_ptr<Task>>& recovered,
+                        std::uint64_t& max_lsn);
+    void remove_persisted_segments();
+    std::string segment_path(std::uint64_t first_lsn) const;
+};
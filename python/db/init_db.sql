@@ -27,10 +27,36 @@ CREATE TABLE IF NOT EXISTS Tasks (
   priority INT NOT NULL DEFAULT 3,
   created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
   
+  -- Serves "next K pending tasks" queries straight from the index
+  INDEX idx_status_priority_created (status, priority, created_at),
+
   FOREIGN KEY (assignee_id) REFERENCES Users(user_id)
     ON DELETE SET NULL
     ON UPDATE CASCADE
 ) ENGINE=InnoDB;
 
+-- -----------------------------------------------------
+-- Table `TaskHistory`
+-- Every status/priority a task has had, delta-encoded: a row only
+-- stores the fields that changed (`fields` bit 1 = status, bit 2 =
+-- priority). Every few versions a keyframe row stores all of them,
+-- so the state at any time is the nearest earlier keyframe plus the
+-- deltas after it, never the whole history.
+-- -----------------------------------------------------
+CREATE TABLE IF NOT EXISTS TaskHistory (
+  history_id BIGINT AUTO_INCREMENT PRIMARY KEY,
+  task_id INT NOT NULL,
+  changed_at_us BIGINT NOT NULL, -- Unix microseconds
+  keyframe TINYINT NOT NULL DEFAULT 0,
+  fields TINYINT NOT NULL,
+  status ENUM('pending', 'in_progress', 'completed') NULL,
+  priority TINYINT NULL,
+
+  -- "Latest keyframe at or before T" is a single index probe
+  INDEX idx_history_keyframes (task_id, keyframe, changed_at_us),
+  -- Deltas after that keyframe are a short range scan
+  INDEX idx_history_task (task_id, history_id)
+) ENGINE=InnoDB;
+
 -- Insert some dummy users for testing
 INSERT INTO Users (username) VALUES ('alice'), ('bob') ON DUPLICATE KEY UPDATE username=username;
\ No newline at end of file